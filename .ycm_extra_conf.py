@@ -81,8 +81,12 @@ flags = [
 def DirectoryOfThisScript():
   return os.path.dirname( os.path.abspath( __file__ ) )
 
+# BuildConfig.json is written in the build directory, found here for in-source
+# builds or when copied next to this script
 compilation_database_folder = ''
-with open('%s/BuildConfig.json' % DirectoryOfThisScript()) as build_config_file:
+build_config_path = '%s/BuildConfig.json' % DirectoryOfThisScript()
+if os.path.exists( build_config_path ):
+  with open( build_config_path ) as build_config_file:
     json_data = json.load(build_config_file)
     compilation_database_folder = json_data['rtp'].encode('ascii','replace')
 
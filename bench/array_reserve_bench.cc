@@ -0,0 +1,88 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <named_types/named_tuple.hpp>
+#include <named_types/literals/integral_string_literal.hpp>
+#include <named_types/extensions/structural_parser.hpp>
+
+namespace {
+size_t constexpr operator"" _s(const char* c, size_t s) {
+  return named_types::basic_lowcase_charset_format::encode(c, s);
+}
+template <size_t EncStr>
+using attr = named_types::named_tag<
+    typename named_types::basic_lowcase_charset_format::decode<EncStr>::type>;
+
+using name = attr<"name"_s>;
+using city = attr<"city"_s>;
+using email = attr<"email"_s>;
+using age = attr<"age"_s>;
+using records = attr<"records"_s>;
+
+// Strings longer than the small string buffer, so that moving a record
+// moves pointers rather than copying characters
+using Record = named_types::named_tuple<std::string(name),
+                                        std::string(city),
+                                        std::string(email),
+                                        int(age)>;
+using Document = named_types::named_tuple<std::vector<Record>(records)>;
+
+std::string generate(size_t count) {
+  std::string result(R"json({"records":[)json");
+  for (size_t index = 0; index < count; ++index) {
+    if (index)
+      result += ',';
+    std::string const number = std::to_string(index);
+    result += R"json({"name":"A person named after the number )json" + number +
+              R"json(","city":"A city somewhere on the planet )json" + number +
+              R"json(","email":"person.number.)json" + number +
+              R"json(@example.com","age":)json" + std::to_string(index % 97) +
+              '}';
+  }
+  result += "]}";
+  return result;
+}
+
+template <class Run> double measure(Run run) {
+  double best = 0.;
+  for (size_t attempt = 0; attempt < 5u; ++attempt) {
+    auto start = std::chrono::steady_clock::now();
+    if (!run()) {
+      std::cerr << "Parse error" << std::endl;
+      return 0.;
+    }
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    if (0u == attempt || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+}
+
+// Parsing of an array of 100k records into a vector, grown element by element
+// or reserved after counting the array on the structural index
+int main() {
+  using namespace named_types::extensions::parsing;
+  std::string const input = generate(100000u);
+
+  structural_parser growing(unknown_keys::fail, parse_mode::merge,
+                            array_sizing::grow);
+  double grown = measure([&]() {
+    Document document;
+    return static_cast<bool>(growing.parse(input, document));
+  });
+
+  structural_parser prescanning(unknown_keys::fail, parse_mode::merge,
+                                array_sizing::prescan);
+  double reserved = measure([&]() {
+    Document document;
+    return static_cast<bool>(prescanning.parse(input, document));
+  });
+
+  std::cout << "grown vector    : " << grown * 1e3 << " ms\n"
+            << "reserved vector : " << reserved * 1e3 << " ms" << std::endl;
+  return 0;
+}
@@ -0,0 +1,201 @@
+#pragma once
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+
+// Timing harness and synthetic documents shared by the benchmarks. The
+// documents are generated in memory from a fixed seed, the same on every
+// machine, and nothing is downloaded.
+//
+// Results are printed as a table, or one line per measurement for tracking
+// them over time when the benchmark is given --format=csv or --format=jsonl.
+
+namespace bench {
+
+enum class output_format { text, csv, jsonl };
+
+struct measurement {
+  std::string schema;
+  std::string parser;
+  size_t bytes;
+  size_t records;
+  // Best time of the runs, zero when the parsing failed
+  double seconds;
+
+  inline double megabytes_per_second() const {
+    return static_cast<double>(bytes) / 1e6 / seconds;
+  }
+  inline double records_per_second() const {
+    return static_cast<double>(records) / seconds;
+  }
+};
+
+class report {
+  std::string suite_;
+  output_format format_;
+
+ public:
+  report(std::string suite, int argc, char** argv)
+      : suite_(std::move(suite))
+      , format_(output_format::text) {
+    for (int index = 1; index < argc; ++index) {
+      if (0 == std::strcmp(argv[index], "--format=csv"))
+        format_ = output_format::csv;
+      else if (0 == std::strcmp(argv[index], "--format=jsonl"))
+        format_ = output_format::jsonl;
+    }
+    if (output_format::csv == format_)
+      std::cout << "suite,schema,parser,bytes,records,seconds,mb_per_s,"
+                   "records_per_s\n";
+  }
+
+  void add(measurement const& result) {
+    bool const failed = 0. == result.seconds;
+    switch (format_) {
+    case output_format::text:
+      std::cout << result.schema << " / " << result.parser << " : ";
+      if (failed)
+        std::cout << "parse error\n";
+      else
+        std::cout << result.megabytes_per_second() << " MB/s, "
+                  << result.records_per_second() << " records/s\n";
+      break;
+    case output_format::csv:
+      std::cout << suite_ << ',' << result.schema << ',' << result.parser
+                << ',' << result.bytes << ',' << result.records << ','
+                << result.seconds << ','
+                << (failed ? 0. : result.megabytes_per_second()) << ','
+                << (failed ? 0. : result.records_per_second()) << '\n';
+      break;
+    case output_format::jsonl:
+      std::cout << R"({"suite":")" << suite_ << R"(","schema":")"
+                << result.schema << R"(","parser":")" << result.parser
+                << R"(","bytes":)" << result.bytes << R"(,"records":)"
+                << result.records << R"(,"seconds":)" << result.seconds
+                << R"(,"mb_per_s":)"
+                << (failed ? 0. : result.megabytes_per_second())
+                << R"(,"records_per_s":)"
+                << (failed ? 0. : result.records_per_second())
+                << R"(,"failed":)" << (failed ? "true" : "false") << "}\n";
+      break;
+    }
+    std::cout.flush();
+  }
+};
+
+// Best time of the runs, zero as soon as one returns false
+template <class Run> double best_time(Run run, size_t runs = 5u) {
+  double best = 0.;
+  for (size_t attempt = 0; attempt < runs; ++attempt) {
+    auto start = std::chrono::steady_clock::now();
+    if (!run())
+      return 0.;
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    if (0u == attempt || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+
+// Synthetic documents : arrays of count records
+
+class generator {
+  std::mt19937 random_;
+
+  std::string word(size_t min_length, size_t max_length) {
+    static char const letters[] = "abcdefghijklmnopqrstuvwxyz";
+    size_t length = min_length + random_() % (max_length - min_length + 1u);
+    std::string result;
+    for (size_t index = 0; index < length; ++index)
+      result += letters[random_() % 26u];
+    return result;
+  }
+
+  // Words, one string out of eight holding escaped quotes
+  std::string text(size_t words) {
+    bool const escaped = 0u == random_() % 8u;
+    std::string result(escaped ? "\\\"" : "");
+    for (size_t index = 0; index < words; ++index) {
+      if (index)
+        result += ' ';
+      result += word(2u, 10u);
+    }
+    if (escaped)
+      result += "\\\"";
+    return result;
+  }
+
+  std::string decimal() {
+    std::string result = std::to_string(random_() % 1000u);
+    return result += '.' + std::to_string(random_() % 100u);
+  }
+
+ public:
+  generator()
+      : random_(42u) {}
+
+  // Random values are drawn one statement at a time, so that the documents do
+  // not depend on the evaluation order of the compiler
+
+  // {"id":1,"name":"...","score":1.5,"active":true}
+  std::string flat(size_t count) {
+    std::string result("[");
+    for (size_t index = 0; index < count; ++index) {
+      if (index)
+        result += ',';
+      result += R"({"id":)" + std::to_string(index) + R"(,"name":")";
+      result += text(3u);
+      result += R"(","score":)";
+      result += decimal();
+      result += R"(,"active":)";
+      result += random_() % 2u ? "true}" : "false}";
+    }
+    return result += ']';
+  }
+
+  // {"id":1,"owner":{"name":"...","address":{"city":"...","zip":12345}}}
+  std::string nested(size_t count) {
+    std::string result("[");
+    for (size_t index = 0; index < count; ++index) {
+      if (index)
+        result += ',';
+      result += R"({"id":)" + std::to_string(index) + R"(,"owner":{"name":")";
+      result += text(2u);
+      result += R"(","address":{"city":")";
+      result += text(1u);
+      result += R"(","zip":)";
+      result += std::to_string(random_() % 100000u) + "}}}";
+    }
+    return result += ']';
+  }
+
+  // {"id":1,"values":[16 integers],"tags":["...", 4 strings]}
+  std::string array_heavy(size_t count) {
+    std::string result("[");
+    for (size_t index = 0; index < count; ++index) {
+      if (index)
+        result += ',';
+      result += R"({"id":)" + std::to_string(index) + R"(,"values":[)";
+      for (size_t value = 0; value < 16u; ++value) {
+        if (value)
+          result += ',';
+        result += std::to_string(random_() % 100000u);
+      }
+      result += R"(],"tags":[)";
+      for (size_t tag = 0; tag < 4u; ++tag) {
+        if (tag)
+          result += ',';
+        result += '"' + word(3u, 8u) + '"';
+      }
+      result += "]}";
+    }
+    return result += ']';
+  }
+};
+
+} // namespace bench
@@ -0,0 +1,285 @@
+#include <cstring>
+#include <string>
+#include <vector>
+#include <rapidjson/document.h>
+#include <named_types/named_tuple.hpp>
+#include <named_types/literals/integral_string_literal.hpp>
+#include <named_types/extensions/rapidjson.hpp>
+#include <named_types/extensions/structural_parser.hpp>
+#include "bench_harness.hpp"
+
+namespace {
+size_t constexpr operator"" _s(const char* c, size_t s) {
+  return named_types::basic_lowcase_charset_format::encode(c, s);
+}
+template <size_t EncStr>
+using attr = named_types::named_tag<
+    typename named_types::basic_lowcase_charset_format::decode<EncStr>::type>;
+
+using id = attr<"id"_s>;
+using name = attr<"name"_s>;
+using score = attr<"score"_s>;
+using active = attr<"active"_s>;
+using owner = attr<"owner"_s>;
+using address = attr<"address"_s>;
+using city = attr<"city"_s>;
+using zip = attr<"zip"_s>;
+using values = attr<"values"_s>;
+using tags = attr<"tags"_s>;
+
+// Schemas of the generated documents, as named tuples and as structures
+// filled by hand
+
+using Flat = named_types::named_tuple<int(id),
+                                      std::string(name),
+                                      double(score),
+                                      bool(active)>;
+using Address = named_types::named_tuple<std::string(city), int(zip)>;
+using Owner = named_types::named_tuple<std::string(name), Address(address)>;
+using Nested = named_types::named_tuple<int(id), Owner(owner)>;
+using ArrayHeavy = named_types::named_tuple<int(id),
+                                            std::vector<int>(values),
+                                            std::vector<std::string>(tags)>;
+
+struct RawFlat {
+  int id;
+  std::string name;
+  double score;
+  bool active;
+};
+
+struct RawNested {
+  int id;
+  std::string name;
+  std::string city;
+  int zip;
+};
+
+struct RawArrayHeavy {
+  int id;
+  std::vector<int> values;
+  std::vector<std::string> tags;
+};
+
+// Handlers written by hand, each key being compared once
+
+enum class Field { none, id, name, score, active, city, zip, values, tags };
+
+Field field_of(char const* key, ::rapidjson::SizeType length) {
+  static char const* const names[] = {"id",     "name", "score",
+                                      "active", "city", "zip",
+                                      "values", "tags"};
+  for (size_t index = 0; index < 8u; ++index) {
+    if (length == std::strlen(names[index]) &&
+        0 == std::memcmp(key, names[index], length))
+      return static_cast<Field>(index + 1u);
+  }
+  return Field::none;
+}
+
+template <class Raw> class RawHandler;
+
+template <class Raw, class Derived>
+class RawHandlerBase
+    : public ::rapidjson::BaseReaderHandler<::rapidjson::UTF8<>, Derived> {
+ protected:
+  std::vector<Raw>& records_;
+  Field field_;
+  size_t depth_;
+
+ public:
+  RawHandlerBase(std::vector<Raw>& records)
+      : records_(records)
+      , field_(Field::none)
+      , depth_(0u) {}
+
+  bool Default() { return true; }
+  bool Uint(unsigned value) {
+    return static_cast<Derived&>(*this).Int(static_cast<int>(value));
+  }
+  bool Key(const char* key, ::rapidjson::SizeType length, bool) {
+    field_ = field_of(key, length);
+    return true;
+  }
+  bool StartObject() {
+    if (1u == ++depth_)
+      records_.emplace_back();
+    return true;
+  }
+  bool EndObject(::rapidjson::SizeType) {
+    --depth_;
+    return true;
+  }
+};
+
+template <>
+class RawHandler<RawFlat>
+    : public RawHandlerBase<RawFlat, RawHandler<RawFlat>> {
+ public:
+  using RawHandlerBase::RawHandlerBase;
+
+  bool Bool(bool value) {
+    if (Field::active == field_)
+      records_.back().active = value;
+    return true;
+  }
+  bool Int(int value) {
+    if (Field::id == field_)
+      records_.back().id = value;
+    return true;
+  }
+  bool Double(double value) {
+    if (Field::score == field_)
+      records_.back().score = value;
+    return true;
+  }
+  bool String(const char* data, ::rapidjson::SizeType length, bool) {
+    if (Field::name == field_)
+      records_.back().name.assign(data, length);
+    return true;
+  }
+};
+
+template <>
+class RawHandler<RawNested>
+    : public RawHandlerBase<RawNested, RawHandler<RawNested>> {
+ public:
+  using RawHandlerBase::RawHandlerBase;
+
+  bool Int(int value) {
+    if (Field::id == field_)
+      records_.back().id = value;
+    else if (Field::zip == field_)
+      records_.back().zip = value;
+    return true;
+  }
+  bool String(const char* data, ::rapidjson::SizeType length, bool) {
+    if (Field::name == field_)
+      records_.back().name.assign(data, length);
+    else if (Field::city == field_)
+      records_.back().city.assign(data, length);
+    return true;
+  }
+};
+
+template <>
+class RawHandler<RawArrayHeavy>
+    : public RawHandlerBase<RawArrayHeavy, RawHandler<RawArrayHeavy>> {
+ public:
+  using RawHandlerBase::RawHandlerBase;
+
+  bool Int(int value) {
+    if (Field::id == field_)
+      records_.back().id = value;
+    else if (Field::values == field_)
+      records_.back().values.push_back(value);
+    return true;
+  }
+  bool String(const char* data, ::rapidjson::SizeType length, bool) {
+    if (Field::tags == field_)
+      records_.back().tags.emplace_back(data, length);
+    return true;
+  }
+};
+
+// Copies of the DOM into the structures
+
+void extract(::rapidjson::Value const& value, RawFlat& record) {
+  record.id = value["id"].GetInt();
+  record.name.assign(value["name"].GetString(),
+                     value["name"].GetStringLength());
+  record.score = value["score"].GetDouble();
+  record.active = value["active"].GetBool();
+}
+
+void extract(::rapidjson::Value const& value, RawNested& record) {
+  record.id = value["id"].GetInt();
+  ::rapidjson::Value const& owner = value["owner"];
+  record.name.assign(owner["name"].GetString(),
+                     owner["name"].GetStringLength());
+  ::rapidjson::Value const& address = owner["address"];
+  record.city.assign(address["city"].GetString(),
+                     address["city"].GetStringLength());
+  record.zip = address["zip"].GetInt();
+}
+
+void extract(::rapidjson::Value const& value, RawArrayHeavy& record) {
+  record.id = value["id"].GetInt();
+  ::rapidjson::Value const& numbers = value["values"];
+  for (auto it = numbers.Begin(); it != numbers.End(); ++it)
+    record.values.push_back(it->GetInt());
+  ::rapidjson::Value const& strings = value["tags"];
+  for (auto it = strings.Begin(); it != strings.End(); ++it)
+    record.tags.emplace_back(it->GetString(), it->GetStringLength());
+}
+
+template <class Target, class MakeHandler>
+bool sax(std::string const& input, MakeHandler make_handler) {
+  Target target;
+  auto handler = make_handler(target);
+  ::rapidjson::Reader reader;
+  ::rapidjson::StringStream stream(input.c_str());
+  return !reader.Parse(stream, handler).IsError();
+}
+
+template <class Raw> bool dom(std::string const& input) {
+  ::rapidjson::Document document;
+  document.Parse(input.c_str());
+  if (document.HasParseError() || !document.IsArray())
+    return false;
+  std::vector<Raw> records(document.Size());
+  for (::rapidjson::SizeType index = 0; index < document.Size(); ++index)
+    extract(document[index], records[index]);
+  return true;
+}
+
+template <class Record, class Raw>
+void run_schema(bench::report& report,
+                char const* schema,
+                std::string const& input,
+                size_t records) {
+  using named_types::extensions::parsing::structural_parser;
+  using named_types::extensions::rapidjson::make_reader_handler;
+  using named_types::extensions::rapidjson::make_static_reader_handler;
+  auto add = [&](char const* parser, double seconds) {
+    report.add({schema, parser, input.size(), records, seconds});
+  };
+
+  add("hand written SAX", bench::best_time([&]() {
+        return sax<std::vector<Raw>>(input, [](std::vector<Raw>& target) {
+          return RawHandler<Raw>(target);
+        });
+      }));
+  add("rapidjson DOM", bench::best_time([&]() { return dom<Raw>(input); }));
+  add("reader_handler", bench::best_time([&]() {
+        return sax<std::vector<Record>>(input, [](std::vector<Record>& target) {
+          return make_reader_handler(target);
+        });
+      }));
+  add("static_reader_handler", bench::best_time([&]() {
+        return sax<std::vector<Record>>(input, [](std::vector<Record>& target) {
+          return make_static_reader_handler(target);
+        });
+      }));
+  structural_parser structural;
+  add("structural_parser", bench::best_time([&]() {
+        std::vector<Record> target;
+        return static_cast<bool>(structural.parse(input, target));
+      }));
+}
+}
+
+// Ingestion of arrays of records of three schemas by the parsers of the
+// library, rapidjson's DOM and handlers written by hand.
+// Options : --format=text|csv|jsonl
+int main(int argc, char** argv) {
+  bench::report report("json_ingestion", argc, argv);
+  bench::generator generator;
+  size_t const count = 100000u;
+  run_schema<Flat, RawFlat>(report, "flat", generator.flat(count), count);
+  run_schema<Nested, RawNested>(report, "nested", generator.nested(count),
+                                count);
+  run_schema<ArrayHeavy, RawArrayHeavy>(report, "array_heavy",
+                                        generator.array_heavy(count), count);
+  return 0;
+}
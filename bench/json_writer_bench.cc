@@ -0,0 +1,143 @@
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <named_types/named_tuple.hpp>
+#include <named_types/literals/integral_string_literal.hpp>
+#include <named_types/extensions/json_writer.hpp>
+
+namespace {
+size_t constexpr operator"" _s(const char* c, size_t s) {
+  return named_types::basic_lowcase_charset_format::encode(c, s);
+}
+template <size_t EncStr>
+using attr = named_types::named_tag<
+    typename named_types::basic_lowcase_charset_format::decode<EncStr>::type>;
+
+using name = attr<"name"_s>;
+using age = attr<"age"_s>;
+using size = attr<"size"_s>;
+using active = attr<"active"_s>;
+using miles = attr<"miles"_s>;
+using children = attr<"children"_s>;
+using scores = attr<"scores"_s>;
+
+using Child = named_types::named_tuple<std::string(name), int(age)>;
+using Record = named_types::named_tuple<std::string(name),
+                                        int(age),
+                                        double(size),
+                                        bool(active),
+                                        std::vector<int>(miles),
+                                        std::vector<Child>(children),
+                                        std::map<std::string, int>(scores)>;
+
+// The ostringstream serializer of demo6
+template <class Tuple> class StreamSerializer {
+  std::ostringstream& output_;
+
+ public:
+  StreamSerializer(std::ostringstream& output)
+      : output_(output) {}
+
+  template <class... Types>
+  void stream_push(named_types::named_tuple<Types...> const& value) {
+    StreamSerializer<named_types::named_tuple<Types...>>(output_).stream(value);
+  }
+  template <class Type> void stream_push(std::vector<Type> const& v) {
+    output_ << '[';
+    for (auto it = begin(v); it != end(v); ++it) {
+      if (begin(v) != it)
+        output_ << ',';
+      stream_push(*it);
+    }
+    output_ << ']';
+  }
+  void stream_push(std::map<std::string, int> const& m) {
+    output_ << '{';
+    for (auto it = begin(m); it != end(m); ++it) {
+      if (begin(m) != it)
+        output_ << ',';
+      output_ << '"' << it->first << "\":" << it->second;
+    }
+    output_ << '}';
+  }
+  void stream_push(std::string const& value) { output_ << '"' << value << '"'; }
+  void stream_push(int value) { output_ << value; }
+  void stream_push(double value) { output_ << value; }
+  void stream_push(bool value) { output_ << value; }
+
+  template <class Tag, class Type>
+  void operator()(Tag const&, Type const& value) {
+    output_ << ((0 < Tuple::template tag_index<Tag>::value) ? "," : "") << '"'
+            << named_types::constexpr_type_name<typename Tag::value_type>::value
+            << "\":";
+    stream_push(value);
+  }
+
+  void stream(Tuple const& t) {
+    output_ << '{';
+    for_each(*this, t);
+    output_ << '}';
+  }
+};
+
+std::vector<Record> generate(size_t count) {
+  std::vector<Record> result(count);
+  for (size_t index = 0; index < count; ++index) {
+    Record& record = result[index];
+    record.get<name>() = "Record number " + std::to_string(index);
+    record.get<age>() = static_cast<int>(index % 97);
+    record.get<size>() = 1. + static_cast<double>(index % 10) / 10.;
+    record.get<active>() = 0u == index % 2;
+    record.get<miles>() = {1, 2, 3, static_cast<int>(index)};
+    record.get<children>() = {Child{"First", 3}, Child{"Second", 8}};
+    record.get<scores>() = {{"math", 12}, {"music", 17}};
+  }
+  return result;
+}
+
+template <class Write> double measure(size_t& bytes, Write write) {
+  double best = 0.;
+  for (size_t run = 0; run < 5u; ++run) {
+    auto start = std::chrono::steady_clock::now();
+    bytes = write();
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    if (0u == run || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+}
+
+int main() {
+  using namespace named_types::extensions::generation;
+  std::vector<Record> const records = generate(200000u);
+
+  size_t stream_bytes = 0u;
+  double stream = measure(stream_bytes, [&records]() {
+    std::ostringstream output;
+    output << std::boolalpha;
+    StreamSerializer<Record> serializer(output);
+    serializer.stream_push(records);
+    return output.str().size();
+  });
+
+  size_t writer_bytes = 0u;
+  json_buffer buffer;
+  double writer = measure(writer_bytes, [&records, &buffer]() {
+    buffer.clear();
+    write_json(buffer, records);
+    return buffer.size();
+  });
+
+  std::cout << "ostringstream serializer : "
+            << static_cast<double>(stream_bytes) / 1e6 / stream << " MB/s\n"
+            << "json_writer              : "
+            << static_cast<double>(writer_bytes) / 1e6 / writer
+            << " MB/s (x" << stream / writer << " faster)" << std::endl;
+  return 0;
+}
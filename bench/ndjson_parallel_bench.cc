@@ -0,0 +1,84 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <named_types/named_tuple.hpp>
+#include <named_types/literals/integral_string_literal.hpp>
+#include <named_types/extensions/rapidjson_parallel.hpp>
+
+namespace {
+size_t constexpr operator"" _s(const char* c, size_t s) {
+  return named_types::basic_lowcase_charset_format::encode(c, s);
+}
+template <size_t EncStr>
+using attr = named_types::named_tag<
+    typename named_types::basic_lowcase_charset_format::decode<EncStr>::type>;
+
+using name = attr<"name"_s>;
+using age = attr<"age"_s>;
+using size = attr<"size"_s>;
+using active = attr<"active"_s>;
+using miles = attr<"miles"_s>;
+
+using Record = named_types::named_tuple<std::string(name),
+                                        int(age),
+                                        double(size),
+                                        bool(active),
+                                        std::vector<int>(miles)>;
+
+std::string generate(size_t count) {
+  std::string result;
+  for (size_t index = 0; index < count; ++index) {
+    result += R"json({"name":"Record number )json" + std::to_string(index) +
+              R"json(","age":)json" + std::to_string(index % 97) +
+              R"json(,"size":1.)json" + std::to_string(index % 10) +
+              R"json(,"active":true,"miles":[1,2,3,)json" +
+              std::to_string(index) + "]}\n";
+  }
+  return result;
+}
+
+template <class Parse> double measure(Parse parse) {
+  double best = 0.;
+  for (size_t run = 0; run < 3u; ++run) {
+    std::vector<Record> output;
+    auto start = std::chrono::steady_clock::now();
+    parse(output);
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    if (0u == run || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+}
+
+int main() {
+  using namespace named_types::extensions::rapidjson;
+  std::string const input = generate(1000000u);
+  double megabytes = static_cast<double>(input.size()) / 1e6;
+
+  double sequential = measure([&input](std::vector<Record>& output) {
+    parse_ndjson<static_reader_handler>(input, output);
+  });
+  std::cout << "parse_ndjson             : " << megabytes / sequential
+            << " MB/s\n";
+
+  size_t const cores = std::max(1u, std::thread::hardware_concurrency());
+  for (size_t threads = 1u; threads <= cores; threads *= 2u) {
+    for (int keep_order = 1; keep_order >= 0; --keep_order) {
+      double parallel = measure(
+          [&input, threads, keep_order](std::vector<Record>& output) {
+            parse_ndjson_parallel<static_reader_handler>(input, output, threads,
+                                                         1 == keep_order);
+          });
+      std::cout << "parse_ndjson_parallel " << threads << "t "
+                << (keep_order ? "ordered  " : "unordered") << ": "
+                << megabytes / parallel << " MB/s (x" << sequential / parallel
+                << ")\n";
+    }
+  }
+  return 0;
+}
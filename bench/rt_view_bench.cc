@@ -0,0 +1,141 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <named_types/named_tuple.hpp>
+#include <named_types/literals/integral_string_literal.hpp>
+#include <named_types/rt_named_tuple.hpp>
+
+namespace {
+size_t constexpr operator"" _s(const char* c, size_t s) {
+  return named_types::basic_lowcase_charset_format::encode(c, s);
+}
+template <size_t EncStr>
+using attr = named_types::named_tag<
+    typename named_types::basic_lowcase_charset_format::decode<EncStr>::type>;
+
+using Record = named_types::named_tuple<int(attr<"fa"_s>),
+                                        int(attr<"fb"_s>),
+                                        int(attr<"fc"_s>),
+                                        int(attr<"fd"_s>),
+                                        double(attr<"fe"_s>),
+                                        double(attr<"ff"_s>),
+                                        double(attr<"fg"_s>),
+                                        double(attr<"fh"_s>),
+                                        std::string(attr<"fi"_s>),
+                                        std::string(attr<"fj"_s>),
+                                        std::string(attr<"fk"_s>),
+                                        std::string(attr<"fl"_s>),
+                                        bool(attr<"fm"_s>),
+                                        bool(attr<"fn"_s>),
+                                        bool(attr<"fo"_s>),
+                                        int(attr<"fp"_s>)>;
+
+// Consumers of views knowing only their interface, called through pointers
+// so that views are really built
+int read_view(named_types::base_const_rt_view const& view) {
+  return *view.retrieve<int>(15u);
+}
+int read_ref(named_types::const_rt_ref ref) { return *ref.retrieve<int>(15u); }
+int read_by_name(named_types::const_rt_ref ref) {
+  return *ref.retrieve<int>(named_types::rt_name("fp", 2u));
+}
+named_types::rt_field<int> field_handle;
+int read_by_handle(named_types::const_rt_ref ref) {
+  return *field_handle.in(ref);
+}
+
+int (*volatile view_reader)(named_types::base_const_rt_view const&) =
+    &read_view;
+int (*volatile ref_reader)(named_types::const_rt_ref) = &read_ref;
+int (*volatile name_reader)(named_types::const_rt_ref) = &read_by_name;
+int (*volatile handle_reader)(named_types::const_rt_ref) = &read_by_handle;
+
+// Records fitting in the cache, viewed again at each round
+size_t constexpr rounds = 200u;
+
+template <class Run> double measure(size_t count, Run run) {
+  double best = 0.;
+  for (size_t attempt = 0; attempt < 5u; ++attempt) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round)
+      run();
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    if (0u == attempt || elapsed < best)
+      best = elapsed;
+  }
+  return best * 1e9 / static_cast<double>(count * rounds);
+}
+}
+
+// Per record cost of viewing each element of a vector of tuples and reading
+// one of its fields through the view, by a function only knowing views : by
+// index, by name, or with a handle to the field found beforehand. Then the
+// cost of keeping the views of all the records in a vector before reading.
+int main() {
+  using namespace named_types;
+  std::vector<Record> records(10000u);
+  for (size_t index = 0; index < records.size(); ++index)
+    std::get<15>(records[index]) = static_cast<int>(index);
+  long long sum = 0;
+
+  double virtual_views = measure(records.size(), [&]() {
+    for (Record const& record : records)
+      sum += view_reader(const_rt_view<Record>(record));
+  });
+
+  double references = measure(records.size(), [&]() {
+    for (Record const& record : records)
+      sum += ref_reader(make_rt_ref(record));
+  });
+
+  rt_descriptor const& descriptor = rt_descriptor_of(records.front());
+  double described = measure(records.size(), [&]() {
+    for (Record const& record : records)
+      sum += ref_reader(const_rt_ref(&record, descriptor));
+  });
+
+  double by_name = measure(records.size(), [&]() {
+    for (Record const& record : records)
+      sum += name_reader(const_rt_ref(&record, descriptor));
+  });
+
+  field_handle = make_rt_ref(records.front()).field<int>("fp");
+  double by_handle = measure(records.size(), [&]() {
+    for (Record const& record : records)
+      sum += handle_reader(const_rt_ref(&record, descriptor));
+  });
+
+  // Views kept for later : allocated virtual views or type erased handles
+  double stored_views = measure(records.size(), [&]() {
+    std::vector<std::unique_ptr<base_const_rt_view>> views;
+    views.reserve(records.size());
+    for (Record const& record : records)
+      views.emplace_back(new const_rt_view<Record>(record));
+    for (auto const& view : views)
+      sum += view_reader(*view);
+  });
+
+  double stored_handles = measure(records.size(), [&]() {
+    std::vector<any_const_rt_view> views;
+    views.reserve(records.size());
+    for (Record const& record : records)
+      views.emplace_back(&record, descriptor);
+    for (any_const_rt_view view : views)
+      sum += ref_reader(view);
+  });
+
+  std::cout << "const_rt_view                 : " << virtual_views << " ns\n"
+            << "const_rt_ref                  : " << references << " ns\n"
+            << "const_rt_ref, known descriptor: " << described << " ns\n"
+            << "const_rt_ref, by name         : " << by_name << " ns\n"
+            << "const_rt_ref, field handle    : " << by_handle << " ns\n"
+            << "stored const_rt_view          : " << stored_views << " ns\n"
+            << "stored any_const_rt_view      : " << stored_handles
+            << " ns\n"
+            << "(checksum " << sum << ")" << std::endl;
+  return 0;
+}
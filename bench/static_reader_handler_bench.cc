@@ -0,0 +1,188 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <named_types/named_tuple.hpp>
+#include <named_types/literals/integral_string_literal.hpp>
+#include <named_types/extensions/rapidjson.hpp>
+
+namespace {
+size_t constexpr operator"" _s(const char* c, size_t s) {
+  return named_types::basic_lowcase_charset_format::encode(c, s);
+}
+template <size_t EncStr>
+using attr = named_types::named_tag<
+    typename named_types::basic_lowcase_charset_format::decode<EncStr>::type>;
+
+using name = attr<"name"_s>;
+using age = attr<"age"_s>;
+using size = attr<"size"_s>;
+using active = attr<"active"_s>;
+using miles = attr<"miles"_s>;
+
+using Record = named_types::named_tuple<std::string(name),
+                                        int(age),
+                                        double(size),
+                                        bool(active),
+                                        std::vector<int>(miles)>;
+
+// The same structure and a handler written by hand for it
+struct RawRecord {
+  std::string name;
+  int age;
+  double size;
+  bool active;
+  std::vector<int> miles;
+};
+
+class RawHandler
+    : public ::rapidjson::BaseReaderHandler<::rapidjson::UTF8<>, RawHandler> {
+  enum class Field { none, name, age, size, active, miles };
+  std::vector<RawRecord>& records_;
+  Field field_;
+  bool in_miles_;
+
+  static bool is(char const* key, ::rapidjson::SizeType length,
+                 char const* name) {
+    return length == std::strlen(name) && 0 == std::memcmp(key, name, length);
+  }
+
+ public:
+  RawHandler(std::vector<RawRecord>& records)
+      : records_(records)
+      , field_(Field::none)
+      , in_miles_(false) {}
+
+  bool Default() { return true; }
+  bool Bool(bool value) {
+    if (Field::active == field_)
+      records_.back().active = value;
+    return true;
+  }
+  bool Int(int value) {
+    if (in_miles_)
+      records_.back().miles.push_back(value);
+    else if (Field::age == field_)
+      records_.back().age = value;
+    return true;
+  }
+  bool Uint(unsigned value) { return Int(static_cast<int>(value)); }
+  bool Double(double value) {
+    if (Field::size == field_)
+      records_.back().size = value;
+    return true;
+  }
+  bool String(const char* data, ::rapidjson::SizeType length, bool) {
+    if (Field::name == field_)
+      records_.back().name.assign(data, length);
+    return true;
+  }
+  bool StartObject() {
+    records_.emplace_back();
+    return true;
+  }
+  bool Key(const char* key, ::rapidjson::SizeType length, bool) {
+    field_ = is(key, length, "name")
+                 ? Field::name
+                 : is(key, length, "age")
+                       ? Field::age
+                       : is(key, length, "size")
+                             ? Field::size
+                             : is(key, length, "active")
+                                   ? Field::active
+                                   : is(key, length, "miles") ? Field::miles
+                                                              : Field::none;
+    return true;
+  }
+  bool StartArray() {
+    in_miles_ = Field::miles == field_;
+    return true;
+  }
+  bool EndArray(::rapidjson::SizeType) {
+    in_miles_ = false;
+    return true;
+  }
+};
+
+std::string generate(size_t count) {
+  std::string result("[");
+  for (size_t index = 0; index < count; ++index) {
+    if (index)
+      result += ',';
+    result += R"json({"name":"Record number )json" + std::to_string(index) +
+              R"json(","age":)json" + std::to_string(index % 97) +
+              R"json(,"size":1.)json" + std::to_string(index % 10) +
+              R"json(,"active":true,"miles":[1,2,3,)json" +
+              std::to_string(index) + "]}";
+  }
+  result += ']';
+  return result;
+}
+
+// Duration of one parse, zero on a parse error
+template <class Target, class MakeHandler>
+double measure(std::string const& input, MakeHandler make_handler) {
+  Target target;
+  auto handler = make_handler(target);
+  ::rapidjson::Reader reader;
+  ::rapidjson::StringStream stream(input.c_str());
+  auto start = std::chrono::steady_clock::now();
+  if (!reader.Parse(stream, handler)) {
+    std::cerr << "Parse error" << std::endl;
+    return 0.;
+  }
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+inline void keep_best(double& best, double elapsed, size_t run) {
+  if (0u == run || elapsed < best)
+    best = elapsed;
+}
+}
+
+int main() {
+  using namespace named_types::extensions::rapidjson;
+  std::string const input = generate(200000u);
+
+  // Runs are interleaved so that the three handlers see the same load
+  double raw = 0.;
+  double dynamic = 0.;
+  double static_ = 0.;
+  for (size_t run = 0; run < 10u; ++run) {
+    keep_best(raw, measure<std::vector<RawRecord>>(
+                       input,
+                       [](std::vector<RawRecord>& t) { return RawHandler(t); }),
+              run);
+    keep_best(dynamic, measure<std::vector<Record>>(
+                           input,
+                           [](std::vector<Record>& t) {
+                             return make_reader_handler(t);
+                           }),
+              run);
+    keep_best(static_, measure<std::vector<Record>>(
+                           input,
+                           [](std::vector<Record>& t) {
+                             return make_static_reader_handler(t);
+                           }),
+              run);
+  }
+
+  double megabytes = static_cast<double>(input.size()) / 1e6;
+  std::cout << "hand written handler   : " << megabytes / raw << " MB/s\n"
+            << "reader_handler         : " << megabytes / dynamic
+            << " MB/s (x" << dynamic / raw << ")\n"
+            << "static_reader_handler  : " << megabytes / static_
+            << " MB/s (x" << static_ / raw << ")" << std::endl;
+
+  // The static handler must stay close to the hand written one
+  double const max_ratio = 1.3;
+  if (0. == raw || 0. == static_ || max_ratio < static_ / raw) {
+    std::cerr << "static_reader_handler is more than x" << max_ratio
+              << " slower than the hand written handler" << std::endl;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,84 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <named_types/named_tuple.hpp>
+#include <named_types/literals/integral_string_literal.hpp>
+#include <named_types/extensions/structural_parser.hpp>
+
+namespace {
+size_t constexpr operator"" _s(const char* c, size_t s) {
+  return named_types::basic_lowcase_charset_format::encode(c, s);
+}
+template <size_t EncStr>
+using attr = named_types::named_tag<
+    typename named_types::basic_lowcase_charset_format::decode<EncStr>::type>;
+
+using name = attr<"name"_s>;
+using age = attr<"age"_s>;
+using size = attr<"size"_s>;
+using active = attr<"active"_s>;
+using miles = attr<"miles"_s>;
+
+using Record = named_types::named_tuple<std::string(name),
+                                        int(age),
+                                        double(size),
+                                        bool(active),
+                                        std::vector<int>(miles)>;
+
+std::string generate(size_t count) {
+  std::string result("[");
+  for (size_t index = 0; index < count; ++index) {
+    if (index)
+      result += ",\n  ";
+    result += R"json({"name": "Record \"number\" )json" +
+              std::to_string(index) + R"json(", "age": )json" +
+              std::to_string(index % 97) + R"json(, "size": 1.)json" +
+              std::to_string(index % 10) +
+              R"json(, "active": true, "miles": [1, 2, 3, )json" +
+              std::to_string(index) + "]}";
+  }
+  result += ']';
+  return result;
+}
+
+template <class Run> double measure(Run run) {
+  double best = 0.;
+  for (size_t attempt = 0; attempt < 5u; ++attempt) {
+    auto start = std::chrono::steady_clock::now();
+    if (!run()) {
+      std::cerr << "Parse error" << std::endl;
+      return 0.;
+    }
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    if (0u == attempt || elapsed < best)
+      best = elapsed;
+  }
+  return best;
+}
+}
+
+int main() {
+  using namespace named_types::extensions::parsing;
+  std::string const input = generate(200000u);
+  double gigabytes = static_cast<double>(input.size()) / 1e9;
+
+  structural_index index;
+  double indexing = measure([&]() {
+    return static_cast<bool>(index.build(input.data(), input.size()));
+  });
+
+  structural_parser parser;
+  double parsing = measure([&]() {
+    std::vector<Record> records;
+    return static_cast<bool>(parser.parse(input, records));
+  });
+
+  std::cout << "first stage (structural index) : " << gigabytes / indexing
+            << " GB/s\n"
+            << "full parse into named_tuples   : " << gigabytes / parsing
+            << " GB/s" << std::endl;
+  return 0;
+}
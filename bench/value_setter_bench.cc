@@ -0,0 +1,94 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <named_types/named_tuple.hpp>
+#include <named_types/literals/integral_string_literal.hpp>
+#include <named_types/extensions/parsing_tools.hpp>
+
+namespace {
+size_t constexpr operator"" _s(const char* c, size_t s) {
+  return named_types::basic_lowcase_charset_format::encode(c, s);
+}
+template <size_t EncStr>
+using attr = named_types::named_tag<
+    typename named_types::basic_lowcase_charset_format::decode<EncStr>::type>;
+
+using name = attr<"name"_s>;
+using age = attr<"age"_s>;
+using size = attr<"size"_s>;
+using active = attr<"active"_s>;
+using miles = attr<"miles"_s>;
+using child = attr<"child"_s>;
+
+using Child = named_types::named_tuple<std::string(name), int(age)>;
+using Record = named_types::named_tuple<std::string(name),
+                                        int(age),
+                                        double(size),
+                                        bool(active),
+                                        std::vector<int>(miles),
+                                        Child(child)>;
+
+using namespace named_types::extensions::parsing;
+using Node = value_setter_interface<char, char, unsigned>;
+
+template <class Run> double measure(size_t count, Run run) {
+  double best = 0.;
+  for (size_t attempt = 0; attempt < 5u; ++attempt) {
+    auto start = std::chrono::steady_clock::now();
+    run(count);
+    double elapsed = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    if (0u == attempt || elapsed < best)
+      best = elapsed;
+  }
+  return best * 1e9 / static_cast<double>(count);
+}
+}
+
+// Per field cost of the setters of value_setter, called through its
+// interface as the handlers do, the key lookup included
+int main() {
+  size_t const count = 20000000u;
+  Record record;
+  frame_arena arena;
+  Node* node = arena.create<value_setter<char, char, unsigned, Record>>(record);
+
+  double set_key = measure(count, [node](size_t iterations) {
+    for (size_t index = 0; index < iterations; ++index)
+      node->setKey("age", 3u);
+  });
+
+  double set_scalars = measure(count / 4u, [node](size_t iterations) {
+    for (size_t index = 0; index < iterations; ++index) {
+      node->setKey("age", 3u);
+      node->setInt(static_cast<int>(index));
+      node->setKey("size", 4u);
+      node->setDouble(static_cast<double>(index));
+      node->setKey("active", 6u);
+      node->setBool(0u == (index & 1u));
+      node->setKey("age", 3u);
+      node->setUint64(index);
+    }
+  });
+
+  frame_arena::mark const start = arena.position();
+  double create_children = measure(count / 2u, [&](size_t iterations) {
+    for (size_t index = 0; index < iterations; ++index) {
+      node->setKey("child", 5u);
+      frame_deleter()(node->createChildNode(arena));
+      arena.release(start);
+      node->setKey("miles", 5u);
+      frame_deleter()(node->createChildSequence(arena));
+      arena.release(start);
+    }
+  });
+
+  std::cout << "setKey                    : " << set_key << " ns\n"
+            << "setKey and scalar setter  : " << set_scalars / 4. - set_key
+            << " ns per field (without key)\n"
+            << "child node and sequence   : " << create_children / 2. - set_key
+            << " ns per creation (without key)" << std::endl;
+  return 0;
+}
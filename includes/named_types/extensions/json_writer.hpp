@@ -0,0 +1,413 @@
+#pragma once
+#include <type_traits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+#include "named_types/named_tuple.hpp"
+#include "named_types/perfect_hash.hpp"
+#include "named_types/literals/string_literal.hpp"
+#include "named_types/extensions/type_traits.hpp"
+#include "named_types/extensions/number_tools.hpp"
+
+namespace named_types {
+namespace extensions {
+namespace generation {
+
+// Growable output buffer, written through raw pointers : reserve() makes room
+// for at most length chars, commit() validates those actually written.
+
+class json_buffer {
+  std::unique_ptr<char[]> data_;
+  size_t size_;
+  size_t capacity_;
+
+  void grow(size_t required) {
+    size_t capacity = capacity_ ? capacity_ : 256u;
+    while (capacity < required)
+      capacity *= 2u;
+    std::unique_ptr<char[]> data(new char[capacity]);
+    if (size_)
+      std::memcpy(data.get(), data_.get(), size_);
+    data_ = std::move(data);
+    capacity_ = capacity;
+  }
+
+ public:
+  json_buffer(size_t capacity = 0u)
+      : data_()
+      , size_(0u)
+      , capacity_(0u) {
+    if (capacity)
+      grow(capacity);
+  }
+
+  inline char* reserve(size_t length) {
+    if (capacity_ - size_ < length)
+      grow(size_ + length);
+    return data_.get() + size_;
+  }
+
+  inline void commit(size_t length) { size_ += length; }
+
+  inline void append(char const* data, size_t length) {
+    std::memcpy(reserve(length), data, length);
+    size_ += length;
+  }
+
+  inline void push_back(char value) {
+    *reserve(1u) = value;
+    ++size_;
+  }
+
+  inline char const* data() const { return data_.get(); }
+  inline size_t size() const { return size_; }
+  inline size_t capacity() const { return capacity_; }
+  inline void clear() { size_ = 0u; }
+  inline std::string str() const { return std::string(data_.get(), size_); }
+};
+
+// Strings
+
+inline constexpr char __json_hex_digit(unsigned value) {
+  return static_cast<char>(value < 10u ? '0' + value : 'a' + value - 10u);
+}
+
+inline void __json_write_string(json_buffer& buffer,
+                                char const* data,
+                                size_t length) {
+  char* const begin = buffer.reserve(2u + 6u * length);
+  char* out = begin;
+  *out++ = '"';
+  for (size_t index = 0; index < length; ++index) {
+    unsigned char value = static_cast<unsigned char>(data[index]);
+    if (0x20u <= value && '"' != value && '\\' != value) {
+      *out++ = static_cast<char>(value);
+      continue;
+    }
+    *out++ = '\\';
+    switch (value) {
+    case '"':
+    case '\\':
+      *out++ = static_cast<char>(value);
+      break;
+    case '\n':
+      *out++ = 'n';
+      break;
+    case '\r':
+      *out++ = 'r';
+      break;
+    case '\t':
+      *out++ = 't';
+      break;
+    default:
+      *out++ = 'u';
+      *out++ = '0';
+      *out++ = '0';
+      *out++ = __json_hex_digit(value >> 4u);
+      *out++ = __json_hex_digit(value & 15u);
+    }
+  }
+  *out++ = '"';
+  buffer.commit(static_cast<size_t>(out - begin));
+}
+
+// Compile time escaping of string literals
+
+template <char Value, bool IsControl = (0 <= Value && Value < 0x20)>
+struct __json_escaped_char {
+  using type = string_literal<char, Value>;
+};
+
+template <char Value> struct __json_escaped_char<Value, true> {
+  using type = string_literal<char,
+                              '\\',
+                              'u',
+                              '0',
+                              '0',
+                              __json_hex_digit(Value >> 4u),
+                              __json_hex_digit(Value & 15u)>;
+};
+
+template <> struct __json_escaped_char<'"', false> {
+  using type = string_literal<char, '\\', '"'>;
+};
+
+template <> struct __json_escaped_char<'\\', false> {
+  using type = string_literal<char, '\\', '\\'>;
+};
+
+template <class T> struct json_escaped;
+
+template <char... chars> struct json_escaped<string_literal<char, chars...>> {
+  using type = concatenate_t<string_literal<char, '"'>,
+                             typename __json_escaped_char<chars>::type...,
+                             string_literal<char, '"'>>;
+};
+
+// Key prefix of a named_tuple field : opening brace or separator, then the
+// quoted and escaped name and the colon, ex: ',"name":'
+
+template <class Name, bool First, bool IsConstexpr = constexpr_name<Name>::value>
+struct json_key_prefix {
+  using type = concatenate_t<string_literal<char, First ? '{' : ','>,
+                             typename json_escaped<Name>::type,
+                             string_literal<char, ':'>>;
+  static inline char const* data() { return type::data; }
+  static inline constexpr size_t size() { return type::data_size; }
+};
+
+template <class Name, bool First> struct json_key_prefix<Name, First, false> {
+  static inline std::string const& value() {
+    static std::string const value = [] {
+      char const* name = type_name<Name>::value;
+      json_buffer buffer;
+      buffer.push_back(First ? '{' : ',');
+      __json_write_string(buffer, name, std::strlen(name));
+      buffer.push_back(':');
+      return buffer.str();
+    }();
+    return value;
+  }
+  static inline char const* data() { return value().data(); }
+  static inline size_t size() { return value().size(); }
+};
+
+// Numbers
+
+#if defined(__cpp_lib_to_chars)
+template <class T>
+inline std::enable_if_t<std::is_integral<T>::value> __json_write_integer(
+    json_buffer& buffer,
+    T value) {
+  char* const begin = buffer.reserve(24u);
+  buffer.commit(static_cast<size_t>(
+      std::to_chars(begin, begin + 24u, value).ptr - begin));
+}
+
+template <class T>
+inline void __json_write_floating(json_buffer& buffer, T value) {
+  if (!std::isfinite(value)) {
+    buffer.append("null", 4u);
+    return;
+  }
+  char* const begin = buffer.reserve(32u);
+  buffer.commit(static_cast<size_t>(
+      std::to_chars(begin, begin + 32u, value).ptr - begin));
+}
+#else
+inline char const* __json_digit_pairs() {
+  static char const pairs[] =
+      "0001020304050607080910111213141516171819202122232425262728293031323334"
+      "3536373839404142434445464748495051525354555657585960616263646566676869"
+      "707172737475767778798081828384858687888990919293949596979899";
+  return pairs;
+}
+
+template <class T>
+inline std::enable_if_t<std::is_unsigned<T>::value> __json_write_integer(
+    json_buffer& buffer,
+    T value) {
+  char digits[24];
+  char* const end = digits + 24;
+  char* cursor = end;
+  while (100u <= value) {
+    cursor -= 2;
+    std::memcpy(cursor, __json_digit_pairs() + 2u * (value % 100u), 2u);
+    value /= 100u;
+  }
+  if (10u <= value) {
+    cursor -= 2;
+    std::memcpy(cursor, __json_digit_pairs() + 2u * value, 2u);
+  } else {
+    *--cursor = static_cast<char>('0' + value);
+  }
+  buffer.append(cursor, static_cast<size_t>(end - cursor));
+}
+
+template <class T>
+inline std::enable_if_t<std::is_signed<T>::value> __json_write_integer(
+    json_buffer& buffer,
+    T value) {
+  using unsigned_type = std::make_unsigned_t<T>;
+  if (value < 0) {
+    buffer.push_back('-');
+    __json_write_integer(buffer, unsigned_type(0u - unsigned_type(value)));
+  } else {
+    __json_write_integer(buffer, unsigned_type(value));
+  }
+}
+
+// Shortest of the two precisions reading back to the same value, in the "C"
+// locale
+template <class T>
+inline void __json_write_floating(json_buffer& buffer, T value) {
+  if (!std::isfinite(value)) {
+    buffer.append("null", 4u);
+    return;
+  }
+  using print_type = std::conditional_t<std::is_same<float, T>::value, double, T>;
+  char* const begin = buffer.reserve(40u);
+  int length = __c_write(begin, 40u, std::numeric_limits<T>::digits10,
+                         print_type(value));
+  if (__c_read<T>(begin, nullptr) != value) {
+    length = __c_write(begin, 40u, std::numeric_limits<T>::max_digits10,
+                       print_type(value));
+  }
+  buffer.commit(static_cast<size_t>(length));
+}
+#endif
+
+// Value writers, to be specialized for custom types
+
+template <class T, class Enable = void> struct json_value_writer;
+
+template <class T>
+inline void write_json(json_buffer& buffer, T const& value) {
+  json_value_writer<T>::write(buffer, value);
+}
+
+template <class T> inline std::string to_json(T const& value) {
+  json_buffer buffer;
+  write_json(buffer, value);
+  return buffer.str();
+}
+
+template <> struct json_value_writer<bool> {
+  static inline void write(json_buffer& buffer, bool value) {
+    if (value)
+      buffer.append("true", 4u);
+    else
+      buffer.append("false", 5u);
+  }
+};
+
+template <class T>
+struct json_value_writer<
+    T,
+    std::enable_if_t<std::is_integral<T>::value && !std::is_same<bool, T>::value>> {
+  static inline void write(json_buffer& buffer, T value) {
+    __json_write_integer(buffer, value);
+  }
+};
+
+template <class T>
+struct json_value_writer<T, std::enable_if_t<std::is_floating_point<T>::value>> {
+  static inline void write(json_buffer& buffer, T value) {
+    __json_write_floating(buffer, value);
+  }
+};
+
+template <class T>
+struct json_value_writer<T,
+                         std::enable_if_t<is_std_basic_string<T>::value ||
+                                          is_string_view<T>::value>> {
+  static inline void write(json_buffer& buffer, T const& value) {
+    __json_write_string(buffer, value.data(), value.size());
+  }
+};
+
+template <class T>
+struct json_value_writer<T, std::enable_if_t<is_unique_ptr<T>::value>> {
+  static inline void write(json_buffer& buffer, T const& value) {
+    if (value)
+      write_json(buffer, *value);
+    else
+      buffer.append("null", 4u);
+  }
+};
+
+template <class T>
+struct json_value_writer<T,
+                         std::enable_if_t<is_sequence_container<T>::value ||
+                                          is_array<T>::value>> {
+  static inline void write(json_buffer& buffer, T const& value) {
+    auto it = std::begin(value);
+    auto const end = std::end(value);
+    buffer.push_back('[');
+    if (end != it) {
+      write_json(buffer, *it);
+      for (++it; end != it; ++it) {
+        buffer.push_back(',');
+        write_json(buffer, *it);
+      }
+    }
+    buffer.push_back(']');
+  }
+};
+
+template <class T>
+inline std::enable_if_t<is_std_basic_string<T>::value> __json_write_key(
+    json_buffer& buffer,
+    T const& key) {
+  __json_write_string(buffer, key.data(), key.size());
+}
+
+template <class T>
+inline std::enable_if_t<std::is_arithmetic<T>::value> __json_write_key(
+    json_buffer& buffer,
+    T const& key) {
+  buffer.push_back('"');
+  write_json(buffer, key);
+  buffer.push_back('"');
+}
+
+template <class T>
+struct json_value_writer<T, std::enable_if_t<is_associative_container<T>::value>> {
+  static inline void write(json_buffer& buffer, T const& value) {
+    char separator = '{';
+    for (auto const& element : value) {
+      buffer.push_back(separator);
+      __json_write_key(buffer, element.first);
+      buffer.push_back(':');
+      write_json(buffer, element.second);
+      separator = ',';
+    }
+    if ('{' == separator)
+      buffer.push_back('{');
+    buffer.push_back('}');
+  }
+};
+
+template <class... Tags> struct json_value_writer<named_tuple<Tags...>> {
+  using tuple_type = named_tuple<Tags...>;
+
+  template <size_t Index>
+  static inline void write_field(json_buffer& buffer, tuple_type const& value) {
+    using prefix = json_key_prefix<
+        typename __ntuple_tag_spec_t<
+            std::tuple_element_t<Index, std::tuple<Tags...>>>::value_type,
+        0u == Index>;
+    buffer.append(prefix::data(), prefix::size());
+    write_json(buffer, std::get<Index>(value));
+  }
+
+  template <size_t... Indexes>
+  static inline void write_fields(json_buffer& buffer,
+                                  tuple_type const& value,
+                                  std::index_sequence<Indexes...>) {
+    using expand = int[];
+    (void)expand{0, (write_field<Indexes>(buffer, value), 0)...};
+  }
+
+  static inline void write(json_buffer& buffer, tuple_type const& value) {
+    if (0u == sizeof...(Tags))
+      buffer.push_back('{');
+    write_fields(buffer, value, std::index_sequence_for<Tags...>());
+    buffer.push_back('}');
+  }
+};
+
+} // namespace generation
+} // namespace extensions
+} // namespace named_types
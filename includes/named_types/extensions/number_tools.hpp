@@ -0,0 +1,113 @@
+#pragma once
+#include <clocale>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace named_types {
+namespace extensions {
+
+// Floating point conversions through the C library, independent of the
+// global locale : numbers are read and written with a '.' whatever the
+// decimal point of LC_NUMERIC.
+
+inline char const* __decimal_point() {
+  char const* point = std::localeconv()->decimal_point;
+  return point && *point ? point : ".";
+}
+
+inline bool __is_c_decimal_point(char const* point) {
+  return '.' == point[0] && '\0' == point[1];
+}
+
+inline float __c_strto(char const* data, char** end, float) {
+  return std::strtof(data, end);
+}
+
+inline double __c_strto(char const* data, char** end, double) {
+  return std::strtod(data, end);
+}
+
+inline long double __c_strto(char const* data, char** end, long double) {
+  return std::strtold(data, end);
+}
+
+// Characters a number, an infinity or a NaN can be made of in the "C" locale
+inline bool __is_c_number_char(char c) {
+  return ('0' <= c && c <= '9') || ('a' <= c && c <= 'z') ||
+         ('A' <= c && c <= 'Z') || '+' == c || '-' == c || '.' == c;
+}
+
+// Reads as strtod in the "C" locale, without skipping leading spaces. Data is
+// null terminated.
+template <class T> inline T __c_read(char const* data, char** end) {
+  char const* point = __decimal_point();
+  if (__is_c_decimal_point(point))
+    return __c_strto(data, end, T());
+
+  // The number is copied with the decimal point of the locale
+  size_t length = 0u;
+  while (__is_c_number_char(data[length]))
+    ++length;
+  char const* dot = static_cast<char const*>(std::memchr(data, '.', length));
+  size_t const dot_position = dot ? static_cast<size_t>(dot - data) : length;
+  size_t const point_length = std::strlen(point);
+  size_t const copy_length = length + (dot ? point_length - 1u : 0u);
+  char buffer[64];
+  std::string long_buffer;
+  char* copy = buffer;
+  if (sizeof(buffer) <= copy_length) {
+    long_buffer.resize(copy_length);
+    copy = &long_buffer[0];
+  }
+  std::memcpy(copy, data, dot_position);
+  if (dot) {
+    std::memcpy(copy + dot_position, point, point_length);
+    std::memcpy(copy + dot_position + point_length, dot + 1,
+                length - dot_position - 1u);
+  }
+  copy[copy_length] = '\0';
+
+  char* copy_end = nullptr;
+  T value = __c_strto(copy, &copy_end, T());
+  if (end) {
+    size_t read = static_cast<size_t>(copy_end - copy);
+    if (dot && dot_position < read)
+      read -= point_length - 1u;
+    *end = const_cast<char*>(data) + read;
+  }
+  return value;
+}
+
+// Writes as snprintf("%.*g") in the "C" locale, returns the length written
+inline int __c_point(char* buffer, int length) {
+  char const* point = __decimal_point();
+  if (length <= 0 || __is_c_decimal_point(point))
+    return length;
+  char* found = std::strstr(buffer, point);
+  if (!found)
+    return length;
+  size_t const point_length = std::strlen(point);
+  *found = '.';
+  std::memmove(found + 1, found + point_length,
+               static_cast<size_t>(buffer + length - found) - point_length +
+                   1u);
+  return length - static_cast<int>(point_length - 1u);
+}
+
+inline int __c_write(char* buffer, size_t size, int precision, double value) {
+  return __c_point(buffer,
+                   std::snprintf(buffer, size, "%.*g", precision, value));
+}
+
+inline int __c_write(char* buffer,
+                     size_t size,
+                     int precision,
+                     long double value) {
+  return __c_point(buffer,
+                   std::snprintf(buffer, size, "%.*Lg", precision, value));
+}
+
+} // namespace extensions
+} // namespace named_types
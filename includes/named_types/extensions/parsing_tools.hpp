@@ -1,115 +1,399 @@
 #pragma once
 #include <type_traits>
+#include <array>
+#include <bitset>
+#include <cctype>
+#include <cerrno>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <typeinfo>
 #include <vector>
 #include <list>
 #include <map>
 #include <unordered_map>
+#include <memory>
+#include <cstddef>
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
 #include "named_types/named_tuple.hpp"
 #include "named_types/rt_named_tuple.hpp"
+#include "named_types/perfect_hash.hpp"
 #include "named_types/extensions/type_traits.hpp"
+#include "named_types/extensions/number_tools.hpp"
+#include "named_types/extensions/static_parsing_tools.hpp"
 
 namespace named_types {
 namespace extensions {
 namespace parsing {
 
-// Basic lexical cast
+// Lexical cast between strings and numbers. Numbers are read and written by
+// std::from_chars and std::to_chars when available, else without streams
+// through the C library, as in the "C" locale. Streams are left to wide
+// strings, booleans and characters. A string has to hold exactly one
+// number : try_lexical_cast returns false on a failure and leaves its target
+// untouched, lexical_cast throws bad_lexical_cast.
+
+struct bad_lexical_cast : std::bad_cast {
+  virtual char const* what() const noexcept override {
+    return "bad lexical cast";
+  }
+};
+
+// Arithmetic types converted as numbers, int8_t and uint8_t included
+template <class T>
+struct __is_number
+    : std::integral_constant<bool,
+                             std::is_arithmetic<T>::value &&
+                                 !std::is_same<bool, T>::value &&
+                                 !is_char<T>::value> {};
+
+template <class T, class Enable = void> struct __string_char {
+  using type = void;
+};
+
+template <class T>
+struct __string_char<T, std::enable_if_t<is_std_basic_string<T>::value>> {
+  using type = typename T::value_type;
+};
+
+template <class T>
+struct __string_char<T, std::enable_if_t<is_raw_string<T>::value>> {
+  using type = std::remove_cv_t<std::remove_pointer_t<std::decay_t<T>>>;
+};
+
+template <class T> using __string_char_t = typename __string_char<T>::type;
+
+template <class CharT, class Traits, class Allocator>
+inline CharT const* __string_data(
+    std::basic_string<CharT, Traits, Allocator> const& value) {
+  return value.c_str();
+}
+
+template <class CharT> inline CharT const* __string_data(CharT const* value) {
+  return value;
+}
+
+template <class CharT, class Traits, class Allocator>
+inline size_t __string_length(
+    std::basic_string<CharT, Traits, Allocator> const& value) {
+  return value.size();
+}
+
+template <class CharT> inline size_t __string_length(CharT const* value) {
+  return std::char_traits<CharT>::length(value);
+}
+
+// Number conversions, data is null terminated
+constexpr size_t __number_chars = 64u;
+
+#if defined(__cpp_lib_to_chars)
+template <class T>
+inline bool __read_number(char const* data, size_t length, T& target) {
+  T value{};
+  std::from_chars_result result = std::from_chars(data, data + length, value);
+  if (std::errc() != result.ec || data + length != result.ptr)
+    return false;
+  target = value;
+  return true;
+}
+
+template <class T> inline size_t __write_number(char* buffer, T value) {
+  return static_cast<size_t>(
+      std::to_chars(buffer, buffer + __number_chars, value).ptr - buffer);
+}
+#else
+template <class T>
+inline std::enable_if_t<std::is_integral<T>::value, bool> __read_number(
+    char const* data,
+    size_t length,
+    T& target) {
+  using unsigned_type = std::make_unsigned_t<T>;
+  char const* const end = data + length;
+  bool const minus = std::is_signed<T>::value && data != end && '-' == *data;
+  if (minus)
+    ++data;
+  if (data == end)
+    return false;
+  unsigned_type const limit =
+      minus ? unsigned_type(unsigned_type(std::numeric_limits<T>::max()) + 1u)
+            : unsigned_type(std::numeric_limits<T>::max());
+  unsigned_type value = 0u;
+  for (; data != end; ++data) {
+    if (*data < '0' || '9' < *data)
+      return false;
+    unsigned_type const digit = unsigned_type(*data - '0');
+    if ((limit - digit) / 10u < value)
+      return false;
+    value = unsigned_type(value * 10u + digit);
+  }
+  target = minus ? T(unsigned_type(0u - value)) : T(value);
+  return true;
+}
+
+template <class T>
+inline std::enable_if_t<std::is_floating_point<T>::value, bool> __read_number(
+    char const* data,
+    size_t length,
+    T& target) {
+  // Spaces and plus signs are read by the C library, not by from_chars
+  if (0u == length || std::isspace(static_cast<unsigned char>(*data)) ||
+      '+' == *data)
+    return false;
+  char* end = nullptr;
+  errno = 0;
+  T value = __c_read<T>(data, &end);
+  if (data + length != end || ERANGE == errno)
+    return false;
+  target = value;
+  return true;
+}
+
+template <class T>
+inline std::enable_if_t<std::is_integral<T>::value, size_t> __write_number(
+    char* buffer,
+    T value) {
+  using unsigned_type = std::make_unsigned_t<T>;
+  bool const minus = value < T(0);
+  unsigned_type magnitude =
+      minus ? unsigned_type(0u - unsigned_type(value)) : unsigned_type(value);
+  char digits[24];
+  char* const end = digits + 24;
+  char* cursor = end;
+  do {
+    *--cursor = static_cast<char>('0' + magnitude % 10u);
+    magnitude = unsigned_type(magnitude / 10u);
+  } while (magnitude);
+  if (minus)
+    *--cursor = '-';
+  std::memcpy(buffer, cursor, static_cast<size_t>(end - cursor));
+  return static_cast<size_t>(end - cursor);
+}
+
+// Shortest of the two precisions reading back to the same value
+template <class T>
+inline std::enable_if_t<std::is_floating_point<T>::value, size_t>
+__write_number(char* buffer, T value) {
+  using print_type =
+      std::conditional_t<std::is_same<float, T>::value, double, T>;
+  int length = __c_write(buffer, __number_chars,
+                         std::numeric_limits<T>::digits10, print_type(value));
+  T read{};
+  if (!__read_number(buffer, static_cast<size_t>(length), read) ||
+      read != value) {
+    length = __c_write(buffer, __number_chars,
+                       std::numeric_limits<T>::max_digits10, print_type(value));
+  }
+  return static_cast<size_t>(length);
+}
+#endif
 
 template <class To, class From>
-inline std::enable_if_t<std::is_arithmetic<From>::value &&
+inline std::enable_if_t<__is_number<From>::value &&
+                            std::is_same<char, __string_char_t<To>>::value &&
                             is_std_basic_string<To>::value,
-                        To>
-lexical_cast(From const& value) {
+                        bool>
+try_lexical_cast(To& target, From const& value) {
+  char buffer[__number_chars];
+  target.assign(buffer, __write_number(buffer, value));
+  return true;
+}
+
+template <class To, class From>
+inline std::enable_if_t<std::is_arithmetic<From>::value &&
+                            is_std_basic_string<To>::value &&
+                            !(__is_number<From>::value &&
+                              std::is_same<char, __string_char_t<To>>::value),
+                        bool>
+try_lexical_cast(To& target, From const& value) {
   std::basic_ostringstream<typename To::value_type,
                            typename To::traits_type,
                            typename To::allocator_type> output;
-  output << value;
-  return output.str();
+  if (!(output << value))
+    return false;
+  target = output.str();
+  return true;
 }
 
 template <class To, class From>
 inline std::enable_if_t<std::is_arithmetic<From>::value &&
                             std::is_arithmetic<To>::value,
-                        To>
-lexical_cast(From const& value) {
-  return static_cast<To>(value);
+                        bool>
+try_lexical_cast(To& target, From const& value) {
+  target = static_cast<To>(value);
+  return true;
 }
 
 template <class To, class From>
-inline std::enable_if_t<is_std_basic_string<From>::value &&
-                            std::is_arithmetic<To>::value,
-                        To>
-lexical_cast(From const& value) {
+inline std::enable_if_t<(is_std_basic_string<From>::value ||
+                         is_raw_string<From>::value) &&
+                            __is_number<To>::value &&
+                            std::is_same<char, __string_char_t<From>>::value,
+                        bool>
+try_lexical_cast(To& target, From const& value) {
+  return __read_number(__string_data(value), __string_length(value), target);
+}
+
+template <class To, class From>
+inline std::enable_if_t<(is_std_basic_string<From>::value ||
+                         is_raw_string<From>::value) &&
+                            std::is_arithmetic<To>::value &&
+                            !(__is_number<To>::value &&
+                              std::is_same<char, __string_char_t<From>>::value),
+                        bool>
+try_lexical_cast(To& target, From const& value) {
+  using CharT = __string_char_t<From>;
+  std::basic_istringstream<CharT> input(
+      std::basic_string<CharT>(__string_data(value), __string_length(value)));
   To result{};
-  std::basic_istringstream<typename From::value_type,
-                           typename From::traits_type,
-                           typename From::allocator_type>(value) >>
-      result;
-  return result;
+  input >> std::noskipws >> result;
+  if (input.fail() || std::char_traits<CharT>::eof() != input.peek())
+    return false;
+  target = result;
+  return true;
 }
 
 template <class To, class From>
-inline std::enable_if_t<is_raw_string<From>::value &&
-                            std::is_arithmetic<To>::value,
-                        To>
-lexical_cast(From const& value) {
+inline auto lexical_cast(From const& value)
+    -> decltype(try_lexical_cast(std::declval<To&>(), value), To()) {
   To result{};
-  std::istringstream(value) >> result;
+  if (!try_lexical_cast(result, value))
+    throw bad_lexical_cast();
   return result;
 }
 
-// Assigner for struct parser
+// Assigner for struct parser, as plain function pointers so that the tables
+// of a tuple are constant
+template <class Source, class Tuple, size_t Index>
+void __assign_field(Tuple& tuple, Source&& source) {
+  std::get<Index>(tuple) = std::move(source);
+}
+
+template <class Source, class Tuple, size_t Index>
+void __cast_assign_field(Tuple& tuple, Source&& source) {
+  std::get<Index>(tuple) =
+      static_cast<std::remove_reference_t<std::tuple_element_t<Index, Tuple>>>(
+          std::move(source));
+}
+
+template <class Source, class Tuple>
+using setter_t = void (*)(Tuple&, Source&&);
+
 template <class Source, class Tuple, size_t Index>
-inline std::enable_if_t<tuple_member_assignable<Source, Tuple, Index>::value,
-                        std::function<void(Tuple&, Source&&)>>
+constexpr std::enable_if_t<tuple_member_assignable<Source, Tuple, Index>::value,
+                           setter_t<Source, Tuple>>
 make_setter() {
-  return [](Tuple& tuple, Source&& source)
-      -> void { std::get<Index>(tuple) = std::move(source); };
+  return &__assign_field<Source, Tuple, Index>;
 }
 
 template <class Source, class Tuple, size_t Index>
-inline std::enable_if_t<
+constexpr std::enable_if_t<
     tuple_member_static_cast_assignable<Source, Tuple, Index>::value,
-    std::function<void(Tuple&, Source&&)>>
+    setter_t<Source, Tuple>>
 make_setter() {
-  return [](Tuple& tuple, Source&& source) -> void {
-    std::get<Index>(tuple) = static_cast<
-        std::remove_reference_t<std::tuple_element_t<Index, Tuple>>>(
-        std::move(source));
-  };
+  return &__cast_assign_field<Source, Tuple, Index>;
 }
 
 template <class Source, class Tuple, size_t Index>
-inline std::enable_if_t<
+constexpr std::enable_if_t<
     tuple_member_not_assignable<Source, Tuple, Index>::value,
-    std::function<void(Tuple&, Source&&)>>
+    setter_t<Source, Tuple>>
 make_setter() {
   return nullptr;
 }
 
+// LIFO memory for parse frames. Released memory is kept, so a reused handler
+// stops allocating once its deepest nesting has been reached.
+class frame_arena {
+  using unit = std::max_align_t;
+  static constexpr size_t block_units = 4096u / sizeof(unit);
+
+  std::vector<std::unique_ptr<unit[]>> blocks_;
+  std::vector<size_t> block_sizes_;
+  size_t block_;
+  size_t offset_;
+
+ public:
+  struct mark {
+    size_t block;
+    size_t offset;
+  };
+
+  frame_arena()
+      : blocks_()
+      , block_sizes_()
+      , block_(0u)
+      , offset_(0u) {}
+
+  inline mark position() const { return {block_, offset_}; }
+
+  inline void* allocate(size_t bytes) {
+    size_t units = (bytes + sizeof(unit) - 1u) / sizeof(unit);
+    while (block_ < blocks_.size() && block_sizes_[block_] < offset_ + units) {
+      ++block_;
+      offset_ = 0u;
+    }
+    if (blocks_.size() == block_) {
+      size_t size = units < block_units ? block_units : units;
+      blocks_.emplace_back(new unit[size]);
+      block_sizes_.push_back(size);
+      offset_ = 0u;
+    }
+    void* result = blocks_[block_].get() + offset_;
+    offset_ += units;
+    return result;
+  }
+
+  inline void release(mark const& position) {
+    block_ = position.block;
+    offset_ = position.offset;
+  }
+
+  template <class T, class... Args> inline T* create(Args&&... args) {
+    return new (allocate(sizeof(T))) T(std::forward<Args>(args)...);
+  }
+};
+
+// Frames built in a frame_arena are only destroyed, memory is released
+// through the arena
+struct frame_deleter {
+  template <class T> inline void operator()(T* frame) const { frame->~T(); }
+};
+
 template <class KeyCharT, class ValueCharT, class SizeType>
 struct value_setter_interface;
 template <class KeyCharT, class ValueCharT, class SizeType>
 struct sequence_pusher_interface;
 
 // This interface can be used either for a named_tuple or a map
+// The key is given once to setKey, as a pointer and a length only valid during
+// the call, and is used by the next value setting or child creation. setKey
+// returns false for a key with no destination.
 template <class KeyCharT, class ValueCharT, class SizeType>
 struct value_setter_interface {
   virtual ~value_setter_interface() = default;
-  virtual bool setNull(std::basic_string<KeyCharT> const&) = 0;
-  virtual bool setBool(std::basic_string<KeyCharT> const&, bool) = 0;
-  virtual bool setInt(std::basic_string<KeyCharT> const&, int) = 0;
-  virtual bool setUint(std::basic_string<KeyCharT> const&, unsigned) = 0;
-  virtual bool setInt64(std::basic_string<KeyCharT> const&, int64_t) = 0;
-  virtual bool setUint64(std::basic_string<KeyCharT> const&, uint64_t) = 0;
-  virtual bool setDouble(std::basic_string<KeyCharT> const&, double) = 0;
-  virtual bool setString(std::basic_string<KeyCharT> const&,
-                         const ValueCharT*,
-                         SizeType) = 0;
-  virtual value_setter_interface*
-  createChildNode(std::basic_string<KeyCharT> const&) = 0;
+  virtual bool setKey(const KeyCharT*, SizeType) = 0;
+  virtual bool setNull() = 0;
+  virtual bool setBool(bool) = 0;
+  virtual bool setInt(int) = 0;
+  virtual bool setUint(unsigned) = 0;
+  virtual bool setInt64(int64_t) = 0;
+  virtual bool setUint64(uint64_t) = 0;
+  virtual bool setDouble(double) = 0;
+  // Transient strings are only valid during the call
+  virtual bool setString(const ValueCharT*, SizeType, bool transient) = 0;
+  virtual value_setter_interface* createChildNode(frame_arena&) = 0;
   virtual sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*
-  createChildSequence(std::basic_string<KeyCharT> const&) = 0;
+  createChildSequence(frame_arena&) = 0;
+  // Called at the end of the object
+  virtual void finish() = 0;
 };
 
 // This interface can be used either for aby SequenceContainer
@@ -123,10 +407,14 @@ struct sequence_pusher_interface {
   virtual bool appendInt64(int64_t) = 0;
   virtual bool appendUint64(uint64_t) = 0;
   virtual bool appendDouble(double) = 0;
-  virtual bool appendString(const ValueCharT*, SizeType) = 0;
+  virtual bool appendString(const ValueCharT*, SizeType, bool transient) = 0;
   virtual value_setter_interface<KeyCharT, ValueCharT, SizeType>*
-  appendChildNode() = 0;
-  virtual sequence_pusher_interface* appendChildSequence() = 0;
+  appendChildNode(frame_arena&) = 0;
+  virtual sequence_pusher_interface* appendChildSequence(frame_arena&) = 0;
+  // Called at the end of the array
+  virtual void finish() = 0;
+  // Whether an element was refused by a sequence of fixed capacity
+  virtual bool overflowed() const = 0;
 };
 
 template <class KeyCharT, class ValueCharT, class SizeType, class T>
@@ -134,24 +422,54 @@ class value_setter;
 template <class KeyCharT, class ValueCharT, class SizeType, class Container>
 class sequence_pusher;
 
+template <class KeyCharT, class ValueCharT, class SizeType, class Tuple>
+using creator_t = value_setter_interface<KeyCharT, ValueCharT, SizeType>* (*)(
+    Tuple&, frame_arena&, parse_mode);
+
+template <class KeyCharT, class ValueCharT, class SizeType, class Tuple>
+using sequence_creator_t =
+    sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>* (*)(
+        Tuple&, frame_arena&, parse_mode);
+
+template <class KeyCharT,
+          class ValueCharT,
+          class SizeType,
+          class Tuple,
+          size_t Index>
+value_setter_interface<KeyCharT, ValueCharT, SizeType>* __create_node(
+    Tuple& tuple, frame_arena& arena, parse_mode mode) {
+  return arena.template create<value_setter<KeyCharT,
+                                            ValueCharT,
+                                            SizeType,
+                                            std::tuple_element_t<Index, Tuple>>>(
+      std::get<Index>(tuple), mode);
+}
+
+template <class KeyCharT,
+          class ValueCharT,
+          class SizeType,
+          class Tuple,
+          size_t Index>
+sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>* __create_sequence(
+    Tuple& tuple, frame_arena& arena, parse_mode mode) {
+  return arena.template create<
+      sequence_pusher<KeyCharT,
+                      ValueCharT,
+                      SizeType,
+                      std::tuple_element_t<Index, Tuple>>>(
+      std::get<Index>(tuple), mode);
+}
+
 template <class KeyCharT,
           class ValueCharT,
           class SizeType,
           class Tuple,
           size_t Index>
-inline std::enable_if_t<
+constexpr std::enable_if_t<
     is_sub_object<std::tuple_element_t<Index, Tuple>>::value,
-    std::function<
-        value_setter_interface<KeyCharT, ValueCharT, SizeType>*(Tuple&)>>
+    creator_t<KeyCharT, ValueCharT, SizeType, Tuple>>
 make_creator() {
-  return [](Tuple & tuple)
-      -> value_setter_interface<KeyCharT, ValueCharT, SizeType> * {
-    return new value_setter<KeyCharT,
-                            ValueCharT,
-                            SizeType,
-                            std::tuple_element_t<Index, Tuple>>(
-        std::get<Index>(tuple));
-  };
+  return &__create_node<KeyCharT, ValueCharT, SizeType, Tuple, Index>;
 }
 
 template <class KeyCharT,
@@ -159,10 +477,9 @@ template <class KeyCharT,
           class SizeType,
           class Tuple,
           size_t Index>
-inline std::enable_if_t<
+constexpr std::enable_if_t<
     !is_sub_object<std::tuple_element_t<Index, Tuple>>::value,
-    std::function<
-        value_setter_interface<KeyCharT, ValueCharT, SizeType>*(Tuple&)>>
+    creator_t<KeyCharT, ValueCharT, SizeType, Tuple>>
 make_creator() {
   return nullptr;
 }
@@ -172,19 +489,11 @@ template <class KeyCharT,
           class SizeType,
           class Tuple,
           size_t Index>
-inline std::enable_if_t<
+constexpr std::enable_if_t<
     is_sequence_container<std::tuple_element_t<Index, Tuple>>::value,
-    std::function<
-        sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*(Tuple&)>>
+    sequence_creator_t<KeyCharT, ValueCharT, SizeType, Tuple>>
 make_sequence_creator() {
-  return [](Tuple & tuple)
-      -> sequence_pusher_interface<KeyCharT, ValueCharT, SizeType> * {
-    return new sequence_pusher<KeyCharT,
-                               ValueCharT,
-                               SizeType,
-                               std::tuple_element_t<Index, Tuple>>(
-        std::get<Index>(tuple));
-  };
+  return &__create_sequence<KeyCharT, ValueCharT, SizeType, Tuple, Index>;
 }
 
 template <class KeyCharT,
@@ -192,10 +501,9 @@ template <class KeyCharT,
           class SizeType,
           class Tuple,
           size_t Index>
-inline std::enable_if_t<
+constexpr std::enable_if_t<
     !is_sequence_container<std::tuple_element_t<Index, Tuple>>::value,
-    std::function<
-        sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*(Tuple&)>>
+    sequence_creator_t<KeyCharT, ValueCharT, SizeType, Tuple>>
 make_sequence_creator() {
   return nullptr;
 }
@@ -210,13 +518,18 @@ class value_setter
   static_assert(is_associative_container<AssociativeContainer>::value,
                 "The used container must be an AssociativeContainer.");
   using value_type = typename AssociativeContainer::mapped_type;
+  using inserter = associative_inserter<AssociativeContainer>;
 
   AssociativeContainer& root_;
+  std::basic_string<KeyCharT> key_;
+  parse_mode mode_;
 
   template <class T>
-  inline std::enable_if_t<std::is_convertible<T, value_type>::value, bool>
-  setFrom(std::basic_string<KeyCharT> const& key, T&& value) {
-    root_.emplace(key, std::move(value));
+  inline std::enable_if_t<std::is_convertible<T, value_type>::value &&
+                              !is_null_into_string<value_type, T>::value,
+                          bool>
+  setFrom(T&& value) {
+    inserter::emplace(root_, key_, value_type(std::move(value)));
     return true;
   }
 
@@ -224,16 +537,17 @@ class value_setter
   inline std::enable_if_t<is_static_cast_assignable<T, value_type>::value &&
                               !std::is_convertible<T, value_type>::value,
                           bool>
-  setFrom(std::basic_string<KeyCharT> const& key, T&& value) {
-    root_.emplace(key, static_cast<value_type>(value));
+  setFrom(T&& value) {
+    inserter::emplace(root_, key_, static_cast<value_type>(value));
     return true;
   }
 
   template <class T>
-  inline std::enable_if_t<!std::is_convertible<T, value_type>::value &&
-                              !is_static_cast_assignable<T, value_type>::value,
+  inline std::enable_if_t<(!std::is_convertible<T, value_type>::value &&
+                           !is_static_cast_assignable<T, value_type>::value) ||
+                              is_null_into_string<value_type, T>::value,
                           bool>
-  setFrom(std::basic_string<KeyCharT> const& key, T&& value) {
+  setFrom(T&&) {
     return false;
   }
 
@@ -241,11 +555,10 @@ class value_setter
   inline std::enable_if_t<
       is_sub_object<T>::value,
       value_setter_interface<KeyCharT, ValueCharT, SizeType>*>
-  createChildNode(std::basic_string<KeyCharT> const& key) {
-    auto inserted = root_.emplace(key, T{});
-    if (inserted.second)
-      return new value_setter<KeyCharT, ValueCharT, SizeType, T>(
-          inserted.first->second);
+  createChildNode(frame_arena& arena) {
+    if (T* inserted = inserter::emplace(root_, key_, T{}))
+      return arena.template create<
+          value_setter<KeyCharT, ValueCharT, SizeType, T>>(*inserted, mode_);
     else
       return nullptr;
   }
@@ -254,7 +567,7 @@ class value_setter
   inline std::enable_if_t<
       !is_sub_object<T>::value,
       value_setter_interface<KeyCharT, ValueCharT, SizeType>*>
-  createChildNode(std::basic_string<KeyCharT> const& key) {
+  createChildNode(frame_arena&) {
     return nullptr;
   }
 
@@ -262,11 +575,11 @@ class value_setter
   inline std::enable_if_t<
       is_sequence_container<T>::value,
       sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*>
-  createChildSequence(std::basic_string<KeyCharT> const& key) {
-    auto inserted = root_.emplace(key, T{});
-    if (inserted.second)
-      return new sequence_pusher<KeyCharT, ValueCharT, SizeType, T>(
-          inserted.first->second);
+  createChildSequence(frame_arena& arena) {
+    if (T* inserted = inserter::emplace(root_, key_, T{}))
+      return arena.template create<
+          sequence_pusher<KeyCharT, ValueCharT, SizeType, T>>(*inserted,
+                                                               mode_);
     else
       return nullptr;
   }
@@ -275,65 +588,74 @@ class value_setter
   inline std::enable_if_t<
       !is_sequence_container<T>::value,
       sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*>
-  createChildSequence(std::basic_string<KeyCharT> const& key) {
+  createChildSequence(frame_arena&) {
     return nullptr;
   }
 
  public:
-  value_setter(AssociativeContainer& root)
+  value_setter(AssociativeContainer& root, parse_mode mode = parse_mode::merge)
       : value_setter_interface<KeyCharT, ValueCharT, SizeType>()
-      , root_(root) {}
+      , root_(root)
+      , key_()
+      , mode_(mode) {
+    if (parse_mode::reuse == mode_)
+      root_.clear();
+    inserter::start(root_);
+  }
 
-  virtual bool setNull(std::basic_string<KeyCharT> const& key) override {
-    return setFrom<std::nullptr_t>(key, nullptr);
+  virtual bool setKey(const KeyCharT* data, SizeType length) override {
+    key_.assign(data, length);
+    return true;
   }
 
-  virtual bool setBool(std::basic_string<KeyCharT> const& key,
-                       bool value) override {
-    return setFrom<bool>(key, std::move(value));
+  virtual bool setNull() override { return setFrom<std::nullptr_t>(nullptr); }
+
+  virtual bool setBool(bool value) override {
+    return setFrom<bool>(std::move(value));
   }
 
-  virtual bool setInt(std::basic_string<KeyCharT> const& key,
-                      int value) override {
-    return setFrom<int>(key, std::move(value));
+  virtual bool setInt(int value) override {
+    return setFrom<int>(std::move(value));
   }
 
-  virtual bool setUint(std::basic_string<KeyCharT> const& key,
-                       unsigned value) override {
-    return setFrom<unsigned>(key, std::move(value));
+  virtual bool setUint(unsigned value) override {
+    return setFrom<unsigned>(std::move(value));
   }
 
-  virtual bool setInt64(std::basic_string<KeyCharT> const& key,
-                        int64_t value) override {
-    return setFrom<int64_t>(key, std::move(value));
+  virtual bool setInt64(int64_t value) override {
+    return setFrom<int64_t>(std::move(value));
   }
 
-  virtual bool setUint64(std::basic_string<KeyCharT> const& key,
-                         uint64_t value) override {
-    return setFrom<uint64_t>(key, std::move(value));
+  virtual bool setUint64(uint64_t value) override {
+    return setFrom<uint64_t>(std::move(value));
   }
 
-  virtual bool setDouble(std::basic_string<KeyCharT> const& key,
-                         double value) override {
-    return setFrom<double>(key, std::move(value));
+  virtual bool setDouble(double value) override {
+    return setFrom<double>(std::move(value));
   }
 
-  virtual bool setString(std::basic_string<KeyCharT> const& key,
-                         const ValueCharT* data,
-                         SizeType length) override {
-    return setFrom<std::basic_string<ValueCharT>>(
-        key, std::basic_string<ValueCharT>(data));
+  virtual bool setString(const ValueCharT* data,
+                         SizeType length,
+                         bool transient) override {
+    value_type value{};
+    if (!static_convert(
+            value, string_value<ValueCharT, SizeType>{data, length, transient}))
+      return false;
+    inserter::emplace(root_, key_, std::move(value));
+    return true;
   }
 
   virtual value_setter_interface<KeyCharT, ValueCharT, SizeType>*
-  createChildNode(std::basic_string<KeyCharT> const& key) override {
-    return createChildNode<value_type>(key);
+  createChildNode(frame_arena& arena) override {
+    return createChildNode<value_type>(arena);
   }
 
   virtual sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*
-  createChildSequence(std::basic_string<KeyCharT> const& key) override {
-    return createChildSequence<value_type>(key);
+  createChildSequence(frame_arena& arena) override {
+    return createChildSequence<value_type>(arena);
   }
+
+  virtual void finish() override { inserter::finish(root_); }
 };
 
 // Specialization for the named tuple
@@ -343,113 +665,124 @@ class value_setter<KeyCharT, ValueCharT, SizeType, named_tuple<Tags...>>
   using Tuple = named_tuple<Tags...>;
 
   Tuple& root_;
-  rt_view<Tuple> rt_root_;
-
-  template <class T> bool setFrom(size_t field_index, T&& value) {
-    static std::array<std::function<void(Tuple&, T && )>, Tuple::size> setters =
-        {make_setter<
-            T,
-            Tuple,
-            Tuple::template tag_index<__ntuple_tag_spec_t<Tags>>::value>()...};
-    std::function<void(Tuple&, T && )> setter(
-        field_index < setters.size() ? setters[field_index] : nullptr);
+  size_t field_index_;
+  parse_mode mode_;
+  std::bitset<Tuple::size> set_fields_;
+
+  inline bool setField(bool set) {
+    if (set && parse_mode::reuse == mode_)
+      set_fields_.set(field_index_);
+    return set;
+  }
+
+  // Tables are constant initialized, there is no guard nor copy on a call
+  template <class T> bool setFrom(T&& value) {
+    static constexpr std::array<setter_t<T, Tuple>, Tuple::size> setters = {
+        {make_setter<T,
+                     Tuple,
+                     Tuple::template tag_index<
+                         __ntuple_tag_spec_t<Tags>>::value>()...}};
+    setter_t<T, Tuple> setter =
+        field_index_ < Tuple::size ? setters[field_index_] : nullptr;
     if (setter) {
       setter(root_, std::move(value));
-      return true;
+      return setField(true);
     }
     return false;
   }
 
  public:
-  value_setter(Tuple& root)
+  value_setter(Tuple& root, parse_mode mode = parse_mode::merge)
       : value_setter_interface<KeyCharT, ValueCharT, SizeType>()
       , root_(root)
-      , rt_root_(root) {}
+      , field_index_(Tuple::size)
+      , mode_(mode)
+      , set_fields_() {}
 
-  virtual bool setNull(std::basic_string<KeyCharT> const& key) override {
-    return setFrom<std::nullptr_t>(rt_root_.index_of(key), nullptr);
+  virtual bool setKey(const KeyCharT* data, SizeType length) override {
+    field_index_ = named_tuple_key_index<Tuple>::get().index_of(data, length);
+    return field_index_ < Tuple::size;
   }
 
-  virtual bool setBool(std::basic_string<KeyCharT> const& key,
-                       bool value) override {
-    return setFrom<bool>(rt_root_.index_of(key), std::move(value));
+  virtual bool setNull() override { return setFrom<std::nullptr_t>(nullptr); }
+
+  virtual bool setBool(bool value) override {
+    return setFrom<bool>(std::move(value));
   }
 
-  virtual bool setInt(std::basic_string<KeyCharT> const& key,
-                      int value) override {
-    return setFrom<int>(rt_root_.index_of(key), std::move(value));
+  virtual bool setInt(int value) override {
+    return setFrom<int>(std::move(value));
   }
 
-  virtual bool setUint(std::basic_string<KeyCharT> const& key,
-                       unsigned value) override {
-    return setFrom<unsigned>(rt_root_.index_of(key), std::move(value));
+  virtual bool setUint(unsigned value) override {
+    return setFrom<unsigned>(std::move(value));
   }
 
-  virtual bool setInt64(std::basic_string<KeyCharT> const& key,
-                        int64_t value) override {
-    return setFrom<int64_t>(rt_root_.index_of(key), std::move(value));
+  virtual bool setInt64(int64_t value) override {
+    return setFrom<int64_t>(std::move(value));
   }
 
-  virtual bool setUint64(std::basic_string<KeyCharT> const& key,
-                         uint64_t value) override {
-    return setFrom<uint64_t>(rt_root_.index_of(key), std::move(value));
+  virtual bool setUint64(uint64_t value) override {
+    return setFrom<uint64_t>(std::move(value));
   }
 
-  virtual bool setDouble(std::basic_string<KeyCharT> const& key,
-                         double value) override {
-    return setFrom<double>(rt_root_.index_of(key), std::move(value));
+  virtual bool setDouble(double value) override {
+    return setFrom<double>(std::move(value));
   }
 
-  virtual bool setString(std::basic_string<KeyCharT> const& key,
-                         const ValueCharT* data,
-                         SizeType length) override {
-    return setFrom<std::basic_string<ValueCharT>>(
-        rt_root_.index_of(key), std::basic_string<ValueCharT>(data));
+  virtual bool setString(const ValueCharT* data,
+                         SizeType length,
+                         bool transient) override {
+    string_value<ValueCharT, SizeType> value{data, length, transient};
+    return setField(field_dispatch<Tuple>::template apply<bool>(
+        root_, field_index_,
+        [&value](auto& field) -> bool { return static_convert(field, value); }));
   }
 
   virtual value_setter_interface<KeyCharT, ValueCharT, SizeType>*
-  createChildNode(std::basic_string<KeyCharT> const& key) override {
-    static std::array<
-        std::function<
-            value_setter_interface<KeyCharT, ValueCharT, SizeType>*(Tuple&)>,
-        Tuple::size> creators = {
-        make_creator<
-            KeyCharT,
-            ValueCharT,
-            SizeType,
-            Tuple,
-            Tuple::template tag_index<__ntuple_tag_spec_t<Tags>>::value>()...};
-    size_t field_index = rt_root_.index_of(key);
-    if (field_index < creators.size()) {
-      std::function<value_setter_interface<KeyCharT, ValueCharT, SizeType>*(
-          Tuple&)> creator = creators[field_index];
-      if (creator)
-        return creator(root_);
+  createChildNode(frame_arena& arena) override {
+    static constexpr std::array<
+        creator_t<KeyCharT, ValueCharT, SizeType, Tuple>, Tuple::size>
+        creators = {{make_creator<KeyCharT,
+                                  ValueCharT,
+                                  SizeType,
+                                  Tuple,
+                                  Tuple::template tag_index<
+                                      __ntuple_tag_spec_t<Tags>>::value>()...}};
+    if (field_index_ < Tuple::size) {
+      creator_t<KeyCharT, ValueCharT, SizeType, Tuple> creator =
+          creators[field_index_];
+      if (creator && setField(true))
+        return creator(root_, arena, mode_);
     }
     return nullptr;
   }
 
   virtual sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*
-  createChildSequence(std::basic_string<KeyCharT> const& key) override {
-    static std::array<
-        std::function<
-            sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*(Tuple&)>,
-        Tuple::size> creators = {
-        make_sequence_creator<
+  createChildSequence(frame_arena& arena) override {
+    static constexpr std::array<
+        sequence_creator_t<KeyCharT, ValueCharT, SizeType, Tuple>,
+        Tuple::size>
+        creators = {{make_sequence_creator<
             KeyCharT,
             ValueCharT,
             SizeType,
             Tuple,
-            Tuple::template tag_index<__ntuple_tag_spec_t<Tags>>::value>()...};
-    size_t field_index = rt_root_.index_of(key);
-    if (field_index < creators.size()) {
-      std::function<sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*(
-          Tuple&)> creator = creators[field_index];
-      if (creator)
-        return creator(root_);
+            Tuple::template tag_index<__ntuple_tag_spec_t<Tags>>::value>()...}};
+    if (field_index_ < Tuple::size) {
+      sequence_creator_t<KeyCharT, ValueCharT, SizeType, Tuple> creator =
+          creators[field_index_];
+      if (creator && setField(true))
+        return creator(root_, arena, mode_);
     }
     return nullptr;
   }
+
+  virtual void finish() override {
+    if (parse_mode::reuse == mode_)
+      reset_unseen_fields(root_,
+                          [this](size_t index) { return set_fields_[index]; });
+  }
 };
 
 // For sequence types
@@ -461,12 +794,26 @@ class sequence_pusher
 
   using value_type = typename Container::value_type;
   Container& root_;
-  std::back_insert_iterator<Container> inserter_;
+  parse_mode mode_;
+  // Elements appended or overwritten so far
+  size_t count_;
+  bool overflowed_;
+
+  inline bool full() {
+    if (!__sequence_full(root_, count_, mode_))
+      return false;
+    overflowed_ = true;
+    return true;
+  }
 
   template <class T>
-  inline std::enable_if_t<std::is_convertible<T, value_type>::value, bool>
+  inline std::enable_if_t<std::is_convertible<T, value_type>::value &&
+                              !is_null_into_string<value_type, T>::value,
+                          bool>
   appendValue(T&& value) {
-    inserter_ = std::move(value);
+    if (full())
+      return false;
+    __append_element(root_, count_, mode_) = std::move(value);
     return true;
   }
 
@@ -475,15 +822,18 @@ class sequence_pusher
                               !std::is_convertible<T, value_type>::value,
                           bool>
   appendValue(T&& value) {
-    inserter_ = static_cast<value_type>(value);
+    if (full())
+      return false;
+    __append_element(root_, count_, mode_) = static_cast<value_type>(value);
     return true;
   }
 
   template <class T>
-  inline std::enable_if_t<!std::is_convertible<T, value_type>::value &&
-                              !is_static_cast_assignable<T, value_type>::value,
+  inline std::enable_if_t<(!std::is_convertible<T, value_type>::value &&
+                           !is_static_cast_assignable<T, value_type>::value) ||
+                              is_null_into_string<value_type, T>::value,
                           bool>
-  appendValue(T&& value) {
+  appendValue(T&&) {
     return false;
   }
 
@@ -491,16 +841,19 @@ class sequence_pusher
   inline std::enable_if_t<
       is_sub_object<T>::value,
       value_setter_interface<KeyCharT, ValueCharT, SizeType>*>
-  appendChildNode() {
-    inserter_ = T{};
-    return new value_setter<KeyCharT, ValueCharT, SizeType, T>(root_.back());
+  appendChildNode(frame_arena& arena) {
+    if (full())
+      return nullptr;
+    return arena.template create<
+        value_setter<KeyCharT, ValueCharT, SizeType, T>>(
+        __append_element(root_, count_, mode_), mode_);
   }
 
   template <class T>
   inline std::enable_if_t<
       !is_sub_object<T>::value,
       value_setter_interface<KeyCharT, ValueCharT, SizeType>*>
-  appendChildNode() {
+  appendChildNode(frame_arena&) {
     return nullptr;
   }
 
@@ -508,24 +861,31 @@ class sequence_pusher
   inline std::enable_if_t<
       is_sequence_container<T>::value,
       sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*>
-  appendChildSequence() {
-    inserter_ = T{};
-    return new sequence_pusher<KeyCharT, ValueCharT, SizeType, T>(root_.back());
+  appendChildSequence(frame_arena& arena) {
+    if (full())
+      return nullptr;
+    return arena.template create<
+        sequence_pusher<KeyCharT, ValueCharT, SizeType, T>>(
+        __append_element(root_, count_, mode_), mode_);
   }
 
   template <class T>
   inline std::enable_if_t<
       !is_sequence_container<T>::value,
       sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*>
-  appendChildSequence() {
+  appendChildSequence(frame_arena&) {
     return nullptr;
   }
 
  public:
-  sequence_pusher(Container& root)
+  sequence_pusher(Container& root, parse_mode mode = parse_mode::merge)
       : sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>()
       , root_(root)
-      , inserter_(std::back_inserter(root)) {}
+      , mode_(mode)
+      , count_(0u)
+      , overflowed_(false) {
+    sequence_inserter<Container>::start(root_);
+  }
 
   virtual bool appendNull() override {
     return appendValue<std::nullptr_t>(nullptr);
@@ -555,19 +915,26 @@ class sequence_pusher
     return appendValue<double>(std::move(value));
   }
 
-  virtual bool appendString(const ValueCharT* data, SizeType length) override {
-    return appendValue<std::basic_string<ValueCharT>>(data);
+  virtual bool appendString(const ValueCharT* data,
+                            SizeType length,
+                            bool transient) override {
+    string_value<ValueCharT, SizeType> source{data, length, transient};
+    return !full() && __append_convert(root_, count_, mode_, source);
   }
 
   virtual value_setter_interface<KeyCharT, ValueCharT, SizeType>*
-  appendChildNode() override {
-    return appendChildNode<value_type>();
+  appendChildNode(frame_arena& arena) override {
+    return appendChildNode<value_type>(arena);
   }
 
   virtual sequence_pusher_interface<KeyCharT, ValueCharT, SizeType>*
-  appendChildSequence() override {
-    return appendChildSequence<value_type>();
+  appendChildSequence(frame_arena& arena) override {
+    return appendChildSequence<value_type>(arena);
   };
+
+  virtual void finish() override { __end_sequence(root_, count_, mode_); }
+
+  virtual bool overflowed() const override { return overflowed_; }
 };
 
 } // namespace parsing
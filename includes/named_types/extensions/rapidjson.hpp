@@ -1,11 +1,16 @@
 #pragma once
 #include <array>
+#include <cstring>
+#include <memory>
 #include <stack>
+#include <vector>
 #include <iterator>
 #include <rapidjson/reader.h>
+#include <rapidjson/memorystream.h>
 #include "named_types/named_tuple.hpp"
 #include "named_types/extensions/type_traits.hpp"
 #include <named_types/extensions/parsing_tools.hpp>
+#include <named_types/extensions/static_parsing_tools.hpp>
 #include "named_types/rt_named_tuple.hpp"
 
 namespace named_types {
@@ -37,36 +42,81 @@ class reader_handler : public ::rapidjson::BaseReaderHandler<
   using SizeType = ::rapidjson::SizeType;
   using StdString = std::basic_string<Ch>;
 
+  using ObjectNode = parsing::value_setter_interface<Ch, Ch, SizeType>;
+  using ArrayNode = parsing::sequence_pusher_interface<Ch, Ch, SizeType>;
+
+  // Nodes live in the arena of the handler
   struct Node {
-    std::unique_ptr<parsing::value_setter_interface<Ch, Ch, SizeType>> obj_node;
-    std::unique_ptr<parsing::sequence_pusher_interface<Ch, Ch, SizeType>>
-        array_node;
+    std::unique_ptr<ObjectNode, parsing::frame_deleter> obj_node;
+    std::unique_ptr<ArrayNode, parsing::frame_deleter> array_node;
+    parsing::frame_arena::mark position;
 
-    Node(parsing::value_setter_interface<Ch, Ch, SizeType>* obj_interface,
-         parsing::sequence_pusher_interface<Ch, Ch, SizeType>* array_interface)
+    Node(ObjectNode* obj_interface,
+         ArrayNode* array_interface,
+         parsing::frame_arena::mark const& arena_position)
         : obj_node(obj_interface)
-        , array_node(array_interface) {}
+        , array_node(array_interface)
+        , position(arena_position) {}
   };
 
-  RootType& root_;
-  std::stack<Node> nodes_;
+  RootType* root_;
+  // Declared first to outlive the nodes it holds
+  parsing::frame_arena arena_;
+  std::stack<Node, std::vector<Node>> nodes_;
   State state_;
-  std::string current_key_;
-  size_t current_index_;
+  parsing::unknown_keys unknown_keys_;
+  // Nesting level inside a skipped object or array, events are only counted
+  size_t skipped_depth_;
+  // Set by an unknown key, its value does not reach the node
+  bool skip_value_;
+  parsing::parse_mode mode_;
+
+  inline bool skipChild() {
+    if (parsing::unknown_keys::skip != unknown_keys_ || nodes_.empty())
+      return false;
+    skipped_depth_ = 1u;
+    return true;
+  }
+
+  inline bool skipValue() {
+    if (!skip_value_)
+      return false;
+    skip_value_ = false;
+    state_ = State::wait_key;
+    return true;
+  }
+
+  inline void endSkippedChild() {
+    if (0u == --skipped_depth_ && State::wait_value == state_)
+      state_ = State::wait_key;
+  }
+
+  inline void popNode() {
+    parsing::frame_arena::mark position = nodes_.top().position;
+    nodes_.pop();
+    arena_.release(position);
+    if (!nodes_.empty()) {
+      state_ = nodes_.top().obj_node ? State::wait_key : State::wait_element;
+    } else {
+      state_ = is_sub_object<RootType>::value ? State::wait_start_object
+                                              : State::wait_start_sequence;
+    }
+  }
 
   template <class T>
   inline typename std::enable_if<
       is_sub_object<T>::value,
       parsing::value_setter_interface<Ch, Ch, SizeType>*>::type
   createRootNode(T& root) {
-    return new parsing::value_setter<Ch, Ch, SizeType, T>(root);
+    return arena_.template create<parsing::value_setter<Ch, Ch, SizeType, T>>(
+        root, mode_);
   }
 
   template <class T>
   inline typename std::enable_if<
       !is_sub_object<T>::value,
       parsing::value_setter_interface<Ch, Ch, SizeType>*>::type
-  createRootNode(T& root) {
+  createRootNode(T&) {
     return nullptr;
   }
 
@@ -75,29 +125,49 @@ class reader_handler : public ::rapidjson::BaseReaderHandler<
       is_sequence_container<T>::value,
       parsing::sequence_pusher_interface<Ch, Ch, SizeType>*>::type
   createRootSequence(T& root) {
-    return new parsing::sequence_pusher<Ch, Ch, SizeType, T>(root);
+    return arena_
+        .template create<parsing::sequence_pusher<Ch, Ch, SizeType, T>>(
+            root, mode_);
   }
 
   template <class T>
   inline typename std::enable_if<
       !is_sequence_container<T>::value,
       parsing::sequence_pusher_interface<Ch, Ch, SizeType>*>::type
-  createRootSequence(T& root) {
+  createRootSequence(T&) {
     return nullptr;
   }
 
  public:
-  reader_handler(RootType& root)
+  reader_handler(RootType& root,
+                 parsing::unknown_keys unknown = parsing::unknown_keys::fail,
+                 parsing::parse_mode mode = parsing::parse_mode::merge)
       : ::rapidjson::BaseReaderHandler<Encoding, reader_handler>()
-      , root_(root)
+      , root_(&root)
+      , arena_()
+      , nodes_()
       , state_(is_sub_object<RootType>::value ? State::wait_start_object
                                               : State::wait_start_sequence)
-      , current_key_()
-      , current_index_(0) {}
+      , unknown_keys_(unknown)
+      , skipped_depth_(0u)
+      , skip_value_(false)
+      , mode_(mode) {}
+
+  // Targets another root, dropping what is left of an interrupted parsing.
+  // Allocated nodes and arena blocks are kept for the next parsing.
+  void reset(RootType& root) {
+    while (!nodes_.empty())
+      popNode();
+    root_ = &root;
+    skipped_depth_ = 0u;
+    skip_value_ = false;
+  }
 
   bool Null() {
+    if (skipped_depth_ || skipValue())
+      return true;
     if (State::wait_value == state_ && nodes_.top().obj_node) {
-      nodes_.top().obj_node->setNull(current_key_);
+      nodes_.top().obj_node->setNull();
       state_ = State::wait_key;
       return true;
     } else if (State::wait_element == state_ && nodes_.top().array_node) {
@@ -108,8 +178,10 @@ class reader_handler : public ::rapidjson::BaseReaderHandler<
   }
 
   bool Bool(bool value) {
+    if (skipped_depth_ || skipValue())
+      return true;
     if (State::wait_value == state_ && nodes_.top().obj_node) {
-      nodes_.top().obj_node->setBool(current_key_, value);
+      nodes_.top().obj_node->setBool(value);
       state_ = State::wait_key;
       return true;
     } else if (State::wait_element == state_ && nodes_.top().array_node) {
@@ -120,8 +192,10 @@ class reader_handler : public ::rapidjson::BaseReaderHandler<
   }
 
   bool Int(int value) {
+    if (skipped_depth_ || skipValue())
+      return true;
     if (State::wait_value == state_ && nodes_.top().obj_node) {
-      nodes_.top().obj_node->setInt(current_key_, value);
+      nodes_.top().obj_node->setInt(value);
       state_ = State::wait_key;
       return true;
     } else if (State::wait_element == state_ && nodes_.top().array_node) {
@@ -132,8 +206,10 @@ class reader_handler : public ::rapidjson::BaseReaderHandler<
   }
 
   bool Uint(unsigned value) {
+    if (skipped_depth_ || skipValue())
+      return true;
     if (State::wait_value == state_ && nodes_.top().obj_node) {
-      nodes_.top().obj_node->setUint(current_key_, value);
+      nodes_.top().obj_node->setUint(value);
       state_ = State::wait_key;
       return true;
     } else if (State::wait_element == state_ && nodes_.top().array_node) {
@@ -144,8 +220,10 @@ class reader_handler : public ::rapidjson::BaseReaderHandler<
   }
 
   bool Int64(int64_t value) {
+    if (skipped_depth_ || skipValue())
+      return true;
     if (State::wait_value == state_ && nodes_.top().obj_node) {
-      nodes_.top().obj_node->setInt64(current_key_, value);
+      nodes_.top().obj_node->setInt64(value);
       state_ = State::wait_key;
       return true;
     } else if (State::wait_element == state_ && nodes_.top().array_node) {
@@ -156,8 +234,10 @@ class reader_handler : public ::rapidjson::BaseReaderHandler<
   }
 
   bool Uint64(uint64_t value) {
+    if (skipped_depth_ || skipValue())
+      return true;
     if (State::wait_value == state_ && nodes_.top().obj_node) {
-      nodes_.top().obj_node->setUint64(current_key_, value);
+      nodes_.top().obj_node->setUint64(value);
       state_ = State::wait_key;
       return true;
     } else if (State::wait_element == state_ && nodes_.top().array_node) {
@@ -168,8 +248,10 @@ class reader_handler : public ::rapidjson::BaseReaderHandler<
   }
 
   bool Double(double value) {
+    if (skipped_depth_ || skipValue())
+      return true;
     if (State::wait_value == state_ && nodes_.top().obj_node) {
-      nodes_.top().obj_node->setDouble(current_key_, value);
+      nodes_.top().obj_node->setDouble(value);
       state_ = State::wait_key;
       return true;
     } else if (State::wait_element == state_ && nodes_.top().array_node) {
@@ -179,103 +261,885 @@ class reader_handler : public ::rapidjson::BaseReaderHandler<
     return false;
   }
 
-  bool String(const Ch* data, SizeType length, bool) {
+  bool String(const Ch* data, SizeType length, bool copy) {
+    if (skipped_depth_ || skipValue())
+      return true;
     if (State::wait_value == state_ && nodes_.top().obj_node) {
-      nodes_.top().obj_node->setString(current_key_, data, length);
+      nodes_.top().obj_node->setString(data, length, copy);
       state_ = State::wait_key;
       return true;
     } else if (State::wait_element == state_ && nodes_.top().array_node) {
-      nodes_.top().array_node->appendString(data, length);
+      nodes_.top().array_node->appendString(data, length, copy);
       return true;
     }
     return false;
   }
 
   bool StartObject() {
+    if (skipped_depth_) {
+      ++skipped_depth_;
+      return true;
+    }
+    if (skip_value_) {
+      skip_value_ = false;
+      return skipChild();
+    }
     if (State::wait_start_object != state_ && State::wait_value != state_ &&
         State::wait_element != state_)
       return false;
 
-    parsing::value_setter_interface<Ch, Ch, SizeType>* interface = nullptr;
+    parsing::frame_arena::mark position = arena_.position();
+    ObjectNode* interface = nullptr;
     if (nodes_.empty()) {
-      interface = createRootNode<RootType>(root_);
+      interface = createRootNode<RootType>(*root_);
     } else if (nodes_.top().obj_node) {
-      interface = nodes_.top().obj_node->createChildNode(current_key_);
+      interface = nodes_.top().obj_node->createChildNode(arena_);
     } else if (nodes_.top().array_node) {
-      interface = nodes_.top().array_node->appendChildNode();
+      interface = nodes_.top().array_node->appendChildNode(arena_);
     }
 
     if (interface) {
       state_ = State::wait_key;
-      nodes_.emplace(interface, nullptr);
+      nodes_.emplace(interface, nullptr, position);
       return true;
     }
 
-    return false;
+    arena_.release(position);
+    return skipChild();
   }
 
-  bool Key(const Ch* str, SizeType len, bool copy) {
+  bool Key(const Ch* str, SizeType len, bool) {
+    if (skipped_depth_)
+      return true;
     if (state_ != State::wait_key)
       return false;
 
-    current_key_ = std::string(str);
+    skip_value_ = !nodes_.top().obj_node->setKey(str, len);
     state_ = State::wait_value;
     return true;
   }
 
   bool EndObject(SizeType) {
+    if (skipped_depth_) {
+      endSkippedChild();
+      return true;
+    }
     if (State::wait_key != state_ && State::wait_end_object != state_)
       return false;
-    nodes_.pop();
-    if (!nodes_.empty()) {
-      state_ = nodes_.top().obj_node ? State::wait_key : State::wait_element;
-    }
+    nodes_.top().obj_node->finish();
+    popNode();
     return true;
   }
 
   bool StartArray() {
+    if (skipped_depth_) {
+      ++skipped_depth_;
+      return true;
+    }
+    if (skip_value_) {
+      skip_value_ = false;
+      return skipChild();
+    }
     if (State::wait_start_sequence != state_ && State::wait_value != state_ &&
         State::wait_element != state_)
       return false;
 
-    parsing::sequence_pusher_interface<Ch, Ch, SizeType>* interface = nullptr;
+    parsing::frame_arena::mark position = arena_.position();
+    ArrayNode* interface = nullptr;
     if (nodes_.empty()) {
-      interface = createRootSequence<RootType>(root_);
+      interface = createRootSequence<RootType>(*root_);
     } else if (nodes_.top().obj_node) {
-      interface = nodes_.top().obj_node->createChildSequence(current_key_);
+      interface = nodes_.top().obj_node->createChildSequence(arena_);
     } else if (nodes_.top().array_node) {
-      interface = nodes_.top().array_node->appendChildSequence();
+      interface = nodes_.top().array_node->appendChildSequence(arena_);
     }
 
     if (interface) {
       state_ = State::wait_element;
-      nodes_.emplace(nullptr, interface);
+      nodes_.emplace(nullptr, interface, position);
       return true;
     }
 
-    return false;
+    arena_.release(position);
+    return skipChild();
   }
 
   bool EndArray(SizeType) {
+    if (skipped_depth_) {
+      endSkippedChild();
+      return true;
+    }
     if (State::wait_element != state_ && State::wait_end_sequence != state_)
       return false;
-    nodes_.pop();
-    if (!nodes_.empty()) {
-      state_ = nodes_.top().obj_node ? State::wait_key : State::wait_element;
+    // Elements past a fixed capacity fail the parsing once their array ends
+    if (nodes_.top().array_node->overflowed())
+      return false;
+    nodes_.top().array_node->finish();
+    popNode();
+    return true;
+  }
+};
+
+// Handler with no virtual call : every type reachable from the root type is
+// known at compile time, a frame only holds the index of its type in that
+// schema. Events are dispatched on this index and on the field index, letting
+// the compiler inline each assignment.
+template <class RootType, class Encoding> class static_reader_handler;
+
+template <class RootType, class Encoding>
+class static_reader_handler
+    : public ::rapidjson::BaseReaderHandler<
+          Encoding,
+          static_reader_handler<RootType, Encoding>> {
+  static_assert(is_sub_object<RootType>::value ||
+                    is_sequence_container<RootType>::value,
+                "Root type of a handler must either be a named_tuple, an "
+                "AssociativeContainer or a SequenceContainer.");
+
+  using Ch = typename Encoding::Ch;
+  using SizeType = ::rapidjson::SizeType;
+  using StdString = std::basic_string<Ch>;
+  using Schema = parsing::schema_types_t<RootType>;
+  using Dispatch = parsing::schema_dispatch<Schema>;
+
+  struct Frame {
+    size_t type_index;
+    void* object;
+    size_t field_index;
+    StdString key;
+    // Count of the elements of a sequence, or position of the set fields
+    // flags of a tuple when reusing
+    size_t count;
+  };
+
+  struct Child {
+    size_t type_index;
+    void* object;
+  };
+
+  // Type index of the child refused by a full sequence, it fails the parsing
+  // even when skipping unknown keys
+  static constexpr size_t overflow_index = static_cast<size_t>(-1);
+
+  template <class Value> struct value_visitor {
+    static_reader_handler& handler;
+    Frame& frame;
+    Value value;
+
+    template <class... Tags>
+    inline bool operator()(named_tuple<Tags...>& tuple) const {
+      if (parsing::field_dispatch<named_tuple<Tags...>>::template apply<bool>(
+              tuple, frame.field_index,
+              [this](auto& field) -> bool {
+                return parsing::static_convert(field, value);
+              }) &&
+          handler.reusing())
+        handler.set_fields_[frame.count + frame.field_index] = true;
+      return true;
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_sequence_container<T>::value, bool>
+    operator()(T& container) const {
+      if (parsing::__sequence_full(container, frame.count, handler.mode_))
+        return false;
+      parsing::__append_convert(container, frame.count, handler.mode_, value);
+      return true;
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_associative_container<T>::value, bool>
+    operator()(T& container) const {
+      typename T::mapped_type element{};
+      if (parsing::static_convert(element, value))
+        parsing::associative_inserter<T>::emplace(container, frame.key,
+                                                  std::move(element));
+      return true;
+    }
+  };
+
+  struct key_visitor {
+    static_reader_handler& handler;
+    Frame& frame;
+    Ch const* data;
+    SizeType length;
+
+    template <class... Tags>
+    inline bool operator()(named_tuple<Tags...>&) const {
+      frame.field_index =
+          named_tuple_key_index<named_tuple<Tags...>>::get().index_of(data,
+                                                                      length);
+      handler.skip_value_ = sizeof...(Tags) == frame.field_index;
+      return true;
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_sequence_container<T>::value, bool>
+    operator()(T&) const {
+      return false;
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_associative_container<T>::value, bool>
+    operator()(T&) const {
+      frame.key.assign(data, length);
+      return true;
+    }
+  };
+
+  template <template <class> class IsChild> struct child_visitor {
+    static_reader_handler& handler;
+    Frame& frame;
+
+    template <class T>
+    static inline std::enable_if_t<IsChild<T>::value, Child> make(T& object) {
+      return {parsing::type_list_index<T, Schema>::value, &object};
+    }
+
+    template <class T>
+    static inline std::enable_if_t<!IsChild<T>::value, Child> make(T&) {
+      return {0u, nullptr};
+    }
+
+    template <class T>
+    inline std::enable_if_t<IsChild<typename T::value_type>::value, Child>
+    append(T& container) const {
+      if (parsing::__sequence_full(container, frame.count, handler.mode_))
+        return {overflow_index, nullptr};
+      return make(parsing::__append_element(container, frame.count,
+                                            handler.mode_));
+    }
+
+    template <class T>
+    inline std::enable_if_t<!IsChild<typename T::value_type>::value, Child>
+    append(T&) const {
+      return {0u, nullptr};
+    }
+
+    template <class T>
+    static inline std::enable_if_t<IsChild<typename T::mapped_type>::value,
+                                   Child>
+    emplace(T& container, StdString const& key) {
+      auto inserted = parsing::associative_inserter<T>::emplace(
+          container, key, typename T::mapped_type{});
+      return inserted ? make(*inserted) : Child{0u, nullptr};
+    }
+
+    template <class T>
+    static inline std::enable_if_t<!IsChild<typename T::mapped_type>::value,
+                                   Child>
+    emplace(T&, StdString const&) {
+      return {0u, nullptr};
+    }
+
+    template <class... Tags>
+    inline Child operator()(named_tuple<Tags...>& tuple) const {
+      Child child =
+          parsing::field_dispatch<named_tuple<Tags...>>::template apply<Child>(
+              tuple, frame.field_index,
+              [](auto& field) -> Child { return make(field); });
+      if (child.object && handler.reusing())
+        handler.set_fields_[frame.count + frame.field_index] = true;
+      return child;
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_sequence_container<T>::value, Child>
+    operator()(T& container) const {
+      return append(container);
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_associative_container<T>::value, Child>
+    operator()(T& container) const {
+      return emplace(container, frame.key);
+    }
+  };
+
+  // Reuse of the current content of a frame object and insertion hooks of
+  // containers, when it starts and ends
+  struct start_visitor {
+    static_reader_handler& handler;
+    Frame& frame;
+
+    template <class... Tags>
+    inline bool operator()(named_tuple<Tags...>&) const {
+      if (handler.reusing()) {
+        frame.count = handler.set_fields_.size();
+        handler.set_fields_.resize(frame.count + sizeof...(Tags), false);
+      }
+      return true;
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_sequence_container<T>::value, bool>
+    operator()(T& container) const {
+      parsing::sequence_inserter<T>::start(container);
+      return true;
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_associative_container<T>::value, bool>
+    operator()(T& container) const {
+      if (handler.reusing())
+        container.clear();
+      parsing::associative_inserter<T>::start(container);
+      return true;
+    }
+  };
+
+  struct end_visitor {
+    static_reader_handler& handler;
+    Frame& frame;
+
+    template <class... Tags>
+    inline bool operator()(named_tuple<Tags...>& tuple) const {
+      if (!handler.reusing())
+        return true;
+      std::vector<bool> const& set_fields = handler.set_fields_;
+      size_t const first = frame.count;
+      parsing::reset_unseen_fields(tuple, [&set_fields, first](size_t index) {
+        return set_fields[first + index];
+      });
+      handler.set_fields_.resize(first);
+      return true;
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_sequence_container<T>::value, bool>
+    operator()(T& container) const {
+      parsing::__end_sequence(container, frame.count, handler.mode_);
+      return true;
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_associative_container<T>::value, bool>
+    operator()(T& container) const {
+      parsing::associative_inserter<T>::finish(container);
+      return true;
+    }
+  };
+
+  RootType* root_;
+  std::vector<Frame> frames_;
+  size_t depth_;
+  parsing::unknown_keys unknown_keys_;
+  // Nesting level inside a skipped object or array, events are only counted
+  size_t skipped_depth_;
+  // Set by an unknown key, its value is not dispatched
+  bool skip_value_;
+  parsing::parse_mode mode_;
+  // Fields set by the objects being parsed into tuples, when reusing
+  std::vector<bool> set_fields_;
+
+  inline bool reusing() const { return parsing::parse_mode::reuse == mode_; }
+
+  template <class Value> inline bool setValue(Value value) {
+    if (skipped_depth_)
+      return true;
+    if (skip_value_) {
+      skip_value_ = false;
+      return true;
+    }
+    if (0u == depth_)
+      return false;
+    Frame& frame = frames_[depth_ - 1u];
+    return Dispatch::template apply<bool>(
+        frame.type_index, frame.object,
+        value_visitor<Value>{*this, frame, value});
+  }
+
+  template <template <class> class IsChild> inline bool startChild() {
+    if (skipped_depth_) {
+      ++skipped_depth_;
+      return true;
     }
+    if (skip_value_) {
+      skip_value_ = false;
+      if (parsing::unknown_keys::skip != unknown_keys_)
+        return false;
+      skipped_depth_ = 1u;
+      return true;
+    }
+    Child child{0u, nullptr};
+    if (0u == depth_) {
+      child = child_visitor<IsChild>::make(*root_);
+    } else {
+      Frame& frame = frames_[depth_ - 1u];
+      child = Dispatch::template apply<Child>(
+          frame.type_index, frame.object,
+          child_visitor<IsChild>{*this, frame});
+    }
+    if (!child.object) {
+      if (parsing::unknown_keys::skip != unknown_keys_ || 0u == depth_ ||
+          overflow_index == child.type_index)
+        return false;
+      skipped_depth_ = 1u;
+      return true;
+    }
+
+    if (frames_.size() == depth_)
+      frames_.emplace_back();
+    Frame& frame = frames_[depth_++];
+    frame.type_index = child.type_index;
+    frame.object = child.object;
+    frame.field_index = static_cast<size_t>(-1);
+    frame.count = 0u;
+    Dispatch::template apply<bool>(frame.type_index, frame.object,
+                                   start_visitor{*this, frame});
+    return true;
+  }
+
+  inline bool endChild() {
+    if (skipped_depth_) {
+      --skipped_depth_;
+      return true;
+    }
+    if (0u == depth_)
+      return false;
+    Frame& frame = frames_[--depth_];
+    Dispatch::template apply<bool>(frame.type_index, frame.object,
+                                   end_visitor{*this, frame});
+    return true;
+  }
+
+ public:
+  static_reader_handler(
+      RootType& root,
+      parsing::unknown_keys unknown = parsing::unknown_keys::fail,
+      parsing::parse_mode mode = parsing::parse_mode::merge)
+      : ::rapidjson::BaseReaderHandler<Encoding, static_reader_handler>()
+      , root_(&root)
+      , frames_()
+      , depth_(0u)
+      , unknown_keys_(unknown)
+      , skipped_depth_(0u)
+      , skip_value_(false)
+      , mode_(mode)
+      , set_fields_() {}
+
+  void reset(RootType& root) {
+    root_ = &root;
+    depth_ = 0u;
+    skipped_depth_ = 0u;
+    skip_value_ = false;
+    set_fields_.clear();
+  }
+
+  bool Null() { return setValue(nullptr); }
+  bool Bool(bool value) { return setValue(value); }
+  bool Int(int value) { return setValue(value); }
+  bool Uint(unsigned value) { return setValue(value); }
+  bool Int64(int64_t value) { return setValue(value); }
+  bool Uint64(uint64_t value) { return setValue(value); }
+  bool Double(double value) { return setValue(value); }
+
+  bool String(const Ch* data, SizeType length, bool copy) {
+    return setValue(parsing::string_value<Ch, SizeType>{data, length, copy});
+  }
+
+  bool StartObject() { return startChild<is_sub_object>(); }
+
+  bool Key(const Ch* str, SizeType len, bool) {
+    if (skipped_depth_)
+      return true;
+    if (0u == depth_)
+      return false;
+    Frame& frame = frames_[depth_ - 1u];
+    return Dispatch::template apply<bool>(frame.type_index, frame.object,
+                                          key_visitor{*this, frame, str, len});
+  }
+
+  bool EndObject(SizeType) { return endChild(); }
+
+  bool StartArray() { return startChild<is_sequence_container>(); }
+
+  bool EndArray(SizeType) { return endChild(); }
+};
+
+// Handler checking an input against the schema of a root type, without
+// building any value : keys have to exist in their tuple, values to be
+// accepted by their destination and objects and arrays to match a sub
+// element. The first violation stops the parsing.
+
+enum class schema_violation {
+  none,
+  unknown_key,
+  unexpected_value,
+  unexpected_object,
+  unexpected_array
+};
+
+template <class RootType, class Encoding>
+class validation_handler
+    : public ::rapidjson::BaseReaderHandler<
+          Encoding,
+          validation_handler<RootType, Encoding>> {
+  static_assert(is_sub_object<RootType>::value ||
+                    is_sequence_container<RootType>::value,
+                "Root type of a handler must either be a named_tuple, an "
+                "AssociativeContainer or a SequenceContainer.");
+
+  using Ch = typename Encoding::Ch;
+  using SizeType = ::rapidjson::SizeType;
+  using StdString = std::basic_string<Ch>;
+  using Schema = parsing::schema_types_t<RootType>;
+  using Dispatch = parsing::schema_type_dispatch<Schema>;
+  static constexpr size_t no_child = static_cast<size_t>(-1);
+
+  struct Frame {
+    size_t type_index;
+    size_t field_index;
+  };
+
+  template <class Source> struct value_visitor {
+    Frame const& frame;
+
+    template <class T>
+    static inline bool accepts(parsing::type_tag<T>) {
+      return parsing::value_accepted<Source, T>::value;
+    }
+
+    template <class... Tags>
+    inline bool operator()(parsing::type_tag<named_tuple<Tags...>>) const {
+      return parsing::field_type_dispatch<named_tuple<Tags...>>::template apply<
+          bool>(frame.field_index,
+                [](auto field) -> bool { return accepts(field); });
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_sequence_container<T>::value, bool> operator()(
+        parsing::type_tag<T>) const {
+      return parsing::value_accepted<Source, typename T::value_type>::value;
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_associative_container<T>::value, bool>
+    operator()(parsing::type_tag<T>) const {
+      return parsing::value_accepted<Source, typename T::mapped_type>::value;
+    }
+  };
+
+  template <template <class> class IsChild> struct child_visitor {
+    Frame const& frame;
+
+    template <class T>
+    static inline std::enable_if_t<IsChild<T>::value, size_t> index(
+        parsing::type_tag<T>) {
+      return parsing::type_list_index<T, Schema>::value;
+    }
+
+    template <class T>
+    static inline std::enable_if_t<!IsChild<T>::value, size_t> index(
+        parsing::type_tag<T>) {
+      return no_child;
+    }
+
+    template <class... Tags>
+    inline size_t operator()(parsing::type_tag<named_tuple<Tags...>>) const {
+      return frame.field_index < sizeof...(Tags)
+                 ? parsing::field_type_dispatch<named_tuple<Tags...>>::
+                       template apply<size_t>(
+                           frame.field_index,
+                           [](auto field) -> size_t { return index(field); })
+                 : no_child;
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_sequence_container<T>::value, size_t>
+    operator()(parsing::type_tag<T>) const {
+      return index(parsing::type_tag<typename T::value_type>{});
+    }
+
+    template <class T>
+    inline std::enable_if_t<is_associative_container<T>::value, size_t>
+    operator()(parsing::type_tag<T>) const {
+      return index(parsing::type_tag<typename T::mapped_type>{});
+    }
+  };
+
+  struct key_visitor {
+    Frame& frame;
+    Ch const* data;
+    SizeType length;
+
+    template <class... Tags>
+    inline bool operator()(parsing::type_tag<named_tuple<Tags...>>) const {
+      frame.field_index =
+          named_tuple_key_index<named_tuple<Tags...>>::get().index_of(data,
+                                                                      length);
+      return frame.field_index < sizeof...(Tags);
+    }
+
+    template <class T>
+    inline std::enable_if_t<!is_named_tuple<T>::value, bool> operator()(
+        parsing::type_tag<T>) const {
+      return true;
+    }
+  };
+
+  std::vector<Frame> frames_;
+  size_t depth_;
+  schema_violation violation_;
+
+  inline bool violate(schema_violation violation) {
+    violation_ = violation;
+    return false;
+  }
+
+  template <class Source> inline bool checkValue() {
+    if (0u == depth_)
+      return false;
+    return Dispatch::template apply<bool>(
+               frames_[depth_ - 1u].type_index,
+               value_visitor<Source>{frames_[depth_ - 1u]}) ||
+           violate(schema_violation::unexpected_value);
+  }
+
+  template <template <class> class IsChild>
+  inline bool startChild(schema_violation violation) {
+    size_t type_index = no_child;
+    if (0u == depth_) {
+      type_index = child_visitor<IsChild>::index(parsing::type_tag<RootType>{});
+    } else {
+      type_index = Dispatch::template apply<size_t>(
+          frames_[depth_ - 1u].type_index,
+          child_visitor<IsChild>{frames_[depth_ - 1u]});
+    }
+    if (no_child == type_index)
+      return violate(violation);
+    if (frames_.size() == depth_)
+      frames_.emplace_back();
+    frames_[depth_++] = {type_index, static_cast<size_t>(-1)};
     return true;
   }
+
+  inline bool endChild() {
+    if (0u == depth_)
+      return false;
+    --depth_;
+    return true;
+  }
+
+ public:
+  validation_handler()
+      : ::rapidjson::BaseReaderHandler<Encoding, validation_handler>()
+      , frames_()
+      , depth_(0u)
+      , violation_(schema_violation::none) {}
+
+  // Prepares another validation, the frames are kept
+  void reset() {
+    depth_ = 0u;
+    violation_ = schema_violation::none;
+  }
+
+  schema_violation violation() const { return violation_; }
+
+  bool Null() { return checkValue<std::nullptr_t>(); }
+  bool Bool(bool) { return checkValue<bool>(); }
+  bool Int(int) { return checkValue<int>(); }
+  bool Uint(unsigned) { return checkValue<unsigned>(); }
+  bool Int64(int64_t) { return checkValue<int64_t>(); }
+  bool Uint64(uint64_t) { return checkValue<uint64_t>(); }
+  bool Double(double) { return checkValue<double>(); }
+  bool String(const Ch*, SizeType, bool) { return checkValue<StdString>(); }
+
+  bool StartObject() {
+    return startChild<is_sub_object>(schema_violation::unexpected_object);
+  }
+
+  bool Key(const Ch* str, SizeType len, bool) {
+    if (0u == depth_)
+      return false;
+    Frame& frame = frames_[depth_ - 1u];
+    return Dispatch::template apply<bool>(frame.type_index,
+                                          key_visitor{frame, str, len}) ||
+           violate(schema_violation::unknown_key);
+  }
+
+  bool EndObject(SizeType) { return endChild(); }
+
+  bool StartArray() {
+    return startChild<is_sequence_container>(
+        schema_violation::unexpected_array);
+  }
+
+  bool EndArray(SizeType) { return endChild(); }
 };
 
 template <class RootType>
 reader_handler<RootType, ::rapidjson::UTF8<>>
-make_reader_handler(RootType& root) {
-  return reader_handler<RootType, ::rapidjson::UTF8<>>(root);
+make_reader_handler(RootType& root,
+                    parsing::unknown_keys unknown = parsing::unknown_keys::fail,
+                    parsing::parse_mode mode = parsing::parse_mode::merge) {
+  return reader_handler<RootType, ::rapidjson::UTF8<>>(root, unknown, mode);
+}
+
+template <class Encoding, class RootType>
+reader_handler<RootType, Encoding> make_reader_handler(
+    RootType& root,
+    parsing::unknown_keys unknown = parsing::unknown_keys::fail,
+    parsing::parse_mode mode = parsing::parse_mode::merge) {
+  return reader_handler<RootType, Encoding>(root, unknown, mode);
+}
+
+template <class RootType>
+static_reader_handler<RootType, ::rapidjson::UTF8<>>
+make_static_reader_handler(
+    RootType& root,
+    parsing::unknown_keys unknown = parsing::unknown_keys::fail,
+    parsing::parse_mode mode = parsing::parse_mode::merge) {
+  return static_reader_handler<RootType, ::rapidjson::UTF8<>>(root, unknown,
+                                                              mode);
 }
 
 template <class Encoding, class RootType>
-reader_handler<RootType, Encoding> make_reader_handler(RootType& root) {
-  return reader_handler<RootType, Encoding>(root);
+static_reader_handler<RootType, Encoding>
+make_static_reader_handler(
+    RootType& root,
+    parsing::unknown_keys unknown = parsing::unknown_keys::fail,
+    parsing::parse_mode mode = parsing::parse_mode::merge) {
+  return static_reader_handler<RootType, Encoding>(root, unknown, mode);
+}
+
+// Handler for a smaller tuple than the records, for instance a
+// parsing::projection_t of them : only its keys are resolved, the values of
+// the others are skipped without being dispatched.
+template <class Projection>
+static_reader_handler<Projection, ::rapidjson::UTF8<>> make_projection_handler(
+    Projection& target,
+    parsing::parse_mode mode = parsing::parse_mode::merge) {
+  return static_reader_handler<Projection, ::rapidjson::UTF8<>>(
+      target, parsing::unknown_keys::skip, mode);
+}
+
+// Validation of inputs against the schema of Schema. The offset is where the
+// reader stopped on the first violation or syntax error, just past the
+// offending token. A validator reuses its frames from one input to another.
+
+struct validation_result {
+  schema_violation violation;
+  ::rapidjson::ParseErrorCode code;
+  size_t offset;
+  inline explicit operator bool() const {
+    return ::rapidjson::kParseErrorNone == code;
+  }
+};
+
+template <class Schema> class json_validator {
+  ::rapidjson::Reader reader_;
+  validation_handler<Schema, ::rapidjson::UTF8<>> handler_;
+
+ public:
+  validation_result validate(char const* data, size_t length) {
+    handler_.reset();
+    ::rapidjson::MemoryStream stream(data, length);
+    if (reader_.Parse(stream, handler_))
+      return {schema_violation::none, ::rapidjson::kParseErrorNone, length};
+    return {handler_.violation(), reader_.GetParseErrorCode(),
+            reader_.GetErrorOffset()};
+  }
+
+  validation_result validate(std::string const& input) {
+    return validate(input.data(), input.size());
+  }
+};
+
+template <class Schema>
+validation_result validate_json(char const* data, size_t length) {
+  return json_validator<Schema>().validate(data, length);
+}
+
+template <class Schema> validation_result validate_json(std::string const& input) {
+  return validate_json<Schema>(input.data(), input.size());
+}
+
+// Newline delimited JSON : one object per line, appended to a vector. A
+// single reader and a single handler are reused across lines. A line failing
+// to parse is reported and leaves no element, the following ones are parsed.
+
+struct ndjson_error {
+  size_t line;   // From 1
+  size_t offset; // In the whole input
+  ::rapidjson::ParseErrorCode code;
+};
+
+struct ndjson_result {
+  size_t lines;
+  size_t records;
+  std::vector<ndjson_error> errors;
+  inline bool ok() const { return errors.empty(); }
+};
+
+inline bool __ndjson_blank(char const* begin, char const* end) {
+  for (; begin != end; ++begin) {
+    if (' ' != *begin && '\t' != *begin && '\r' != *begin)
+      return false;
+  }
+  return true;
+}
+
+template <template <class, class> class Handler = reader_handler,
+          class Tuple,
+          class Allocator>
+ndjson_result parse_ndjson(
+    char const* data,
+    size_t length,
+    std::vector<Tuple, Allocator>& output,
+    parsing::unknown_keys unknown = parsing::unknown_keys::fail) {
+  static_assert(is_sub_object<Tuple>::value,
+                "Records of a NDJSON input must be objects.");
+  char const* const end = data + length;
+
+  size_t lines = 1u;
+  for (char const* cursor = data;
+       cursor != end && (cursor = static_cast<char const*>(std::memchr(
+                             cursor, '\n', static_cast<size_t>(end - cursor))));
+       ++cursor)
+    ++lines;
+  output.reserve(output.size() + lines);
+
+  ndjson_result result{0u, 0u, {}};
+  Tuple detached{};
+  Handler<Tuple, ::rapidjson::UTF8<>> handler(detached, unknown);
+  ::rapidjson::Reader reader;
+  size_t line = 1u;
+  for (char const* begin = data; begin < end; ++line) {
+    char const* line_end = static_cast<char const*>(
+        std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+    if (!line_end)
+      line_end = end;
+    if (!__ndjson_blank(begin, line_end)) {
+      output.emplace_back();
+      handler.reset(output.back());
+      ::rapidjson::MemoryStream stream(begin,
+                                       static_cast<size_t>(line_end - begin));
+      if (reader.Parse(stream, handler)) {
+        ++result.records;
+      } else {
+        handler.reset(detached);
+        output.pop_back();
+        result.errors.push_back(
+            {line, static_cast<size_t>(begin - data) + reader.GetErrorOffset(),
+             reader.GetParseErrorCode()});
+      }
+    }
+    // The last line may end with the input rather than a newline
+    begin = line_end == end ? end : line_end + 1;
+  }
+  result.lines = line - 1u;
+  return result;
+}
+
+template <template <class, class> class Handler = reader_handler,
+          class Tuple,
+          class Allocator>
+ndjson_result parse_ndjson(
+    std::string const& input,
+    std::vector<Tuple, Allocator>& output,
+    parsing::unknown_keys unknown = parsing::unknown_keys::fail) {
+  return parse_ndjson<Handler>(input.data(), input.size(), output, unknown);
 }
 
 } // namespace rapidjson
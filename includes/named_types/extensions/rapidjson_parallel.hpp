@@ -0,0 +1,148 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "named_types/extensions/rapidjson.hpp"
+
+namespace named_types {
+namespace extensions {
+namespace rapidjson {
+
+// Chunk boundaries of a NDJSON input, every chunk but the last ending on a
+// line end. JSON strings can not hold raw line ends, a line end always is a
+// record boundary.
+inline std::vector<size_t> __ndjson_boundaries(char const* data,
+                                               size_t length,
+                                               size_t chunk_size) {
+  std::vector<size_t> boundaries(1u, 0u);
+  size_t position = 0u;
+  while (chunk_size < length - position) {
+    char const* line_end = static_cast<char const*>(
+        std::memchr(data + position + chunk_size, '\n',
+                    length - position - chunk_size));
+    if (!line_end)
+      break;
+    position = static_cast<size_t>(line_end - data) + 1u;
+    boundaries.push_back(position);
+  }
+  if (length != boundaries.back())
+    boundaries.push_back(length);
+  return boundaries;
+}
+
+// Parallel parse_ndjson : the input is split in chunks taken by a pool of
+// thread_count workers (hardware concurrency by default), each parsing into
+// its own vector. Records are appended in input order, or as soon as a chunk
+// is done if keep_order is false. Errors are reported as by parse_ndjson.
+template <template <class, class> class Handler = reader_handler,
+          class Tuple,
+          class Allocator>
+ndjson_result parse_ndjson_parallel(char const* data,
+                                    size_t length,
+                                    std::vector<Tuple, Allocator>& output,
+                                    size_t thread_count = 0u,
+                                    bool keep_order = true,
+                                    parsing::unknown_keys unknown =
+                                        parsing::unknown_keys::fail) {
+  if (0u == thread_count)
+    thread_count = std::max(1u, std::thread::hardware_concurrency());
+  size_t const min_chunk_size = 1u << 16u;
+  size_t const chunk_size =
+      std::max(min_chunk_size, length / (4u * thread_count));
+  std::vector<size_t> const boundaries =
+      __ndjson_boundaries(data, length, chunk_size);
+  size_t const chunk_count = boundaries.size() - 1u;
+  if (1u == thread_count || chunk_count <= 1u)
+    return parse_ndjson<Handler>(data, length, output, unknown);
+  thread_count = std::min(thread_count, chunk_count);
+
+  std::vector<std::vector<Tuple, Allocator>> records(chunk_count);
+  std::vector<ndjson_result> results(chunk_count);
+  std::atomic<size_t> next_chunk(0u);
+  std::mutex output_mutex;
+  std::exception_ptr failure;
+
+  auto work = [&]() {
+    try {
+      for (size_t chunk = next_chunk++; chunk < chunk_count;
+           chunk = next_chunk++) {
+        results[chunk] = parse_ndjson<Handler>(
+            data + boundaries[chunk], boundaries[chunk + 1u] - boundaries[chunk],
+            records[chunk], unknown);
+        if (!keep_order) {
+          std::lock_guard<std::mutex> lock(output_mutex);
+          output.insert(output.end(),
+                        std::make_move_iterator(records[chunk].begin()),
+                        std::make_move_iterator(records[chunk].end()));
+          std::vector<Tuple, Allocator>().swap(records[chunk]);
+        }
+      }
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(output_mutex);
+      if (!failure)
+        failure = std::current_exception();
+      next_chunk = chunk_count;
+    }
+  };
+
+  std::vector<std::thread> workers;
+  workers.reserve(thread_count - 1u);
+  for (size_t index = 1u; index < thread_count; ++index) {
+    // Chunks are taken from a shared counter : when a thread can not be
+    // created, those already started and the calling one parse its share
+    try {
+      workers.emplace_back(work);
+    } catch (...) {
+      break;
+    }
+  }
+  work();
+  for (auto& worker : workers)
+    worker.join();
+  if (failure)
+    std::rethrow_exception(failure);
+
+  // Lines and offsets of the errors are made relative to the whole input
+  ndjson_result result{0u, 0u, {}};
+  for (size_t chunk = 0u; chunk < chunk_count; ++chunk) {
+    for (auto const& error : results[chunk].errors) {
+      result.errors.push_back({result.lines + error.line,
+                               boundaries[chunk] + error.offset, error.code});
+    }
+    result.lines += results[chunk].lines;
+    result.records += results[chunk].records;
+  }
+
+  if (keep_order) {
+    output.reserve(output.size() + result.records);
+    for (auto& chunk_records : records) {
+      output.insert(output.end(),
+                    std::make_move_iterator(chunk_records.begin()),
+                    std::make_move_iterator(chunk_records.end()));
+      std::vector<Tuple, Allocator>().swap(chunk_records);
+    }
+  }
+  return result;
+}
+
+template <template <class, class> class Handler = reader_handler,
+          class Tuple,
+          class Allocator>
+ndjson_result parse_ndjson_parallel(std::string const& input,
+                                    std::vector<Tuple, Allocator>& output,
+                                    size_t thread_count = 0u,
+                                    bool keep_order = true,
+                                    parsing::unknown_keys unknown =
+                                        parsing::unknown_keys::fail) {
+  return parse_ndjson_parallel<Handler>(input.data(), input.size(), output,
+                                        thread_count, keep_order, unknown);
+}
+
+} // namespace rapidjson
+} // namespace extensions
+} // namespace named_types
@@ -0,0 +1,519 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "named_types/extensions/number_tools.hpp"
+#include "named_types/extensions/rapidjson.hpp"
+
+namespace named_types {
+namespace extensions {
+namespace rapidjson {
+
+// Resumable parser fed with the chunks of a JSON document as they arrive, for
+// instance from a socket. Events reach the handler as soon as their token is
+// complete : with a reader_handler, a record is filled once its closing brace
+// is fed. Between two chunks, only the nesting and an unfinished token are
+// kept, the handler keeps its own state.
+
+enum class push_status { incomplete, complete, failed };
+
+template <class Handler> class push_parser {
+  using Ch = char;
+  using SizeType = ::rapidjson::SizeType;
+
+  enum class expect {
+    value,
+    value_or_end_array,
+    key_or_end_object,
+    key,
+    colon,
+    comma_or_end,
+    end
+  };
+
+  enum class lexeme { none, string, escape, unicode, number, literal };
+
+  struct Container {
+    bool object;
+    SizeType count;
+  };
+
+  Handler* handler_;
+  std::vector<Container> containers_;
+  // Unfinished string or number, also strings holding escapes
+  std::basic_string<Ch> buffer_;
+  expect expect_;
+  lexeme lexeme_;
+  bool key_;
+  // Remaining characters of true, false or null
+  char const* literal_;
+  unsigned unicode_;
+  unsigned hex_digits_;
+  unsigned high_surrogate_;
+  size_t offset_;
+  ::rapidjson::ParseErrorCode code_;
+
+  static inline bool is_space(Ch c) {
+    return ' ' == c || '\n' == c || '\r' == c || '\t' == c;
+  }
+
+  static inline bool is_digit(Ch c) { return '0' <= c && c <= '9'; }
+
+  static inline bool is_number_part(Ch c) {
+    return is_digit(c) || '-' == c || '+' == c || '.' == c || 'e' == c ||
+           'E' == c;
+  }
+
+  inline bool fail(::rapidjson::ParseErrorCode code) {
+    code_ = code;
+    return false;
+  }
+
+  inline bool check(bool handled) {
+    return handled || fail(::rapidjson::kParseErrorTermination);
+  }
+
+  inline void valueDone() {
+    if (containers_.empty()) {
+      expect_ = expect::end;
+    } else {
+      ++containers_.back().count;
+      expect_ = expect::comma_or_end;
+    }
+  }
+
+  inline bool startContainer(bool object) {
+    if (!check(object ? handler_->StartObject() : handler_->StartArray()))
+      return false;
+    containers_.push_back({object, 0u});
+    expect_ = object ? expect::key_or_end_object : expect::value_or_end_array;
+    return true;
+  }
+
+  inline bool endContainer() {
+    Container container = containers_.back();
+    containers_.pop_back();
+    if (!check(container.object ? handler_->EndObject(container.count)
+                                : handler_->EndArray(container.count)))
+      return false;
+    valueDone();
+    return true;
+  }
+
+  inline bool emitString(Ch const* data, size_t length) {
+    lexeme_ = lexeme::none;
+    if (key_) {
+      expect_ = expect::colon;
+      return check(handler_->Key(data, static_cast<SizeType>(length), true));
+    }
+    valueDone();
+    return check(handler_->String(data, static_cast<SizeType>(length), true));
+  }
+
+  inline void appendCodePoint(unsigned code_point) {
+    if (code_point < 0x80u) {
+      buffer_ += static_cast<Ch>(code_point);
+    } else if (code_point < 0x800u) {
+      buffer_ += static_cast<Ch>(0xC0u | (code_point >> 6u));
+      buffer_ += static_cast<Ch>(0x80u | (code_point & 0x3Fu));
+    } else if (code_point < 0x10000u) {
+      buffer_ += static_cast<Ch>(0xE0u | (code_point >> 12u));
+      buffer_ += static_cast<Ch>(0x80u | ((code_point >> 6u) & 0x3Fu));
+      buffer_ += static_cast<Ch>(0x80u | (code_point & 0x3Fu));
+    } else {
+      buffer_ += static_cast<Ch>(0xF0u | (code_point >> 18u));
+      buffer_ += static_cast<Ch>(0x80u | ((code_point >> 12u) & 0x3Fu));
+      buffer_ += static_cast<Ch>(0x80u | ((code_point >> 6u) & 0x3Fu));
+      buffer_ += static_cast<Ch>(0x80u | (code_point & 0x3Fu));
+    }
+  }
+
+  inline bool escape(Ch c) {
+    if (high_surrogate_ && 'u' != c)
+      return fail(::rapidjson::kParseErrorStringUnicodeSurrogateInvalid);
+    lexeme_ = lexeme::string;
+    switch (c) {
+    case '"':
+    case '\\':
+    case '/':
+      buffer_ += c;
+      break;
+    case 'b':
+      buffer_ += '\b';
+      break;
+    case 'f':
+      buffer_ += '\f';
+      break;
+    case 'n':
+      buffer_ += '\n';
+      break;
+    case 'r':
+      buffer_ += '\r';
+      break;
+    case 't':
+      buffer_ += '\t';
+      break;
+    case 'u':
+      lexeme_ = lexeme::unicode;
+      unicode_ = 0u;
+      hex_digits_ = 0u;
+      break;
+    default:
+      return fail(::rapidjson::kParseErrorStringEscapeInvalid);
+    }
+    return true;
+  }
+
+  inline bool unicode(Ch c) {
+    unsigned digit = 0u;
+    if (is_digit(c))
+      digit = static_cast<unsigned>(c - '0');
+    else if ('a' <= c && c <= 'f')
+      digit = static_cast<unsigned>(c - 'a') + 10u;
+    else if ('A' <= c && c <= 'F')
+      digit = static_cast<unsigned>(c - 'A') + 10u;
+    else
+      return fail(::rapidjson::kParseErrorStringUnicodeEscapeInvalidHex);
+    unicode_ = (unicode_ << 4u) | digit;
+    if (4u != ++hex_digits_)
+      return true;
+
+    lexeme_ = lexeme::string;
+    bool const low = 0xDC00u <= unicode_ && unicode_ <= 0xDFFFu;
+    if (high_surrogate_) {
+      if (!low)
+        return fail(::rapidjson::kParseErrorStringUnicodeSurrogateInvalid);
+      appendCodePoint(0x10000u + ((high_surrogate_ - 0xD800u) << 10u) +
+                      (unicode_ - 0xDC00u));
+      high_surrogate_ = 0u;
+    } else if (0xD800u <= unicode_ && unicode_ <= 0xDBFFu) {
+      high_surrogate_ = unicode_;
+    } else if (low) {
+      return fail(::rapidjson::kParseErrorStringUnicodeSurrogateInvalid);
+    } else {
+      appendCodePoint(unicode_);
+    }
+    return true;
+  }
+
+  // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?, integers are given to
+  // the handler as the reader would, with the smallest fitting type
+  inline bool emitNumber() {
+    lexeme_ = lexeme::none;
+    Ch const* cursor = buffer_.c_str();
+    bool const minus = '-' == *cursor;
+    if (minus)
+      ++cursor;
+    if (!is_digit(*cursor))
+      return fail(::rapidjson::kParseErrorValueInvalid);
+    uint64_t value = 0u;
+    bool integral = true;
+    if ('0' == *cursor) {
+      ++cursor;
+    } else {
+      for (; is_digit(*cursor); ++cursor) {
+        uint64_t digit = static_cast<uint64_t>(*cursor - '0');
+        if ((UINT64_MAX - digit) / 10u < value)
+          integral = false;
+        value = value * 10u + digit;
+      }
+    }
+    if ('.' == *cursor) {
+      integral = false;
+      if (!is_digit(*++cursor))
+        return fail(::rapidjson::kParseErrorNumberMissFraction);
+      while (is_digit(*cursor))
+        ++cursor;
+    }
+    if ('e' == *cursor || 'E' == *cursor) {
+      integral = false;
+      ++cursor;
+      if ('+' == *cursor || '-' == *cursor)
+        ++cursor;
+      if (!is_digit(*cursor))
+        return fail(::rapidjson::kParseErrorNumberMissExponent);
+      while (is_digit(*cursor))
+        ++cursor;
+    }
+    if ('\0' != *cursor)
+      return fail(::rapidjson::kParseErrorValueInvalid);
+
+    valueDone();
+    if (integral && !minus) {
+      return check(value <= UINT32_MAX
+                       ? handler_->Uint(static_cast<unsigned>(value))
+                       : handler_->Uint64(value));
+    }
+    if (integral && value <= 0x80000000u) {
+      return check(
+          handler_->Int(static_cast<int>(-static_cast<int64_t>(value))));
+    }
+    if (integral && value <= 0x8000000000000000u)
+      return check(handler_->Int64(static_cast<int64_t>(0u - value)));
+    double number = __c_read<double>(buffer_.c_str(), nullptr);
+    if (std::isinf(number))
+      return fail(::rapidjson::kParseErrorNumberTooBig);
+    return check(handler_->Double(number));
+  }
+
+  inline bool emitLiteral() {
+    lexeme_ = lexeme::none;
+    valueDone();
+    switch (buffer_[0]) {
+    case 't':
+      return check(handler_->Bool(true));
+    case 'f':
+      return check(handler_->Bool(false));
+    default:
+      return check(handler_->Null());
+    }
+  }
+
+  inline bool startValue(Ch c) {
+    switch (c) {
+    case '{':
+      return startContainer(true);
+    case '[':
+      return startContainer(false);
+    case '"':
+      lexeme_ = lexeme::string;
+      key_ = false;
+      buffer_.clear();
+      return true;
+    case 't':
+      literal_ = "rue";
+      break;
+    case 'f':
+      literal_ = "alse";
+      break;
+    case 'n':
+      literal_ = "ull";
+      break;
+    default:
+      if ('-' != c && !is_digit(c))
+        return fail(::rapidjson::kParseErrorValueInvalid);
+      lexeme_ = lexeme::number;
+      buffer_.assign(1u, c);
+      return true;
+    }
+    lexeme_ = lexeme::literal;
+    buffer_.assign(1u, c);
+    return true;
+  }
+
+  // A structural character outside of any token
+  inline bool token(Ch c) {
+    switch (expect_) {
+    case expect::value_or_end_array:
+      if (']' == c)
+        return endContainer();
+    // Falls through
+    case expect::value:
+      return startValue(c);
+    case expect::key_or_end_object:
+      if ('}' == c)
+        return endContainer();
+    // Falls through
+    case expect::key:
+      if ('"' != c)
+        return fail(::rapidjson::kParseErrorObjectMissName);
+      lexeme_ = lexeme::string;
+      key_ = true;
+      buffer_.clear();
+      return true;
+    case expect::colon:
+      if (':' != c)
+        return fail(::rapidjson::kParseErrorObjectMissColon);
+      expect_ = expect::value;
+      return true;
+    case expect::comma_or_end:
+      if (containers_.back().object) {
+        if (',' == c)
+          expect_ = expect::key;
+        else if ('}' == c)
+          return endContainer();
+        else
+          return fail(::rapidjson::kParseErrorObjectMissCommaOrCurlyBracket);
+      } else {
+        if (',' == c)
+          expect_ = expect::value;
+        else if (']' == c)
+          return endContainer();
+        else
+          return fail(
+              ::rapidjson::kParseErrorArrayMissCommaOrSquareBracket);
+      }
+      return true;
+    default:
+      return fail(::rapidjson::kParseErrorDocumentRootNotSingular);
+    }
+  }
+
+  inline push_status status() const {
+    if (::rapidjson::kParseErrorNone != code_)
+      return push_status::failed;
+    return expect::end == expect_ && lexeme::none == lexeme_
+               ? push_status::complete
+               : push_status::incomplete;
+  }
+
+ public:
+  push_parser(Handler& handler)
+      : handler_(&handler)
+      , containers_()
+      , buffer_()
+      , expect_(expect::value)
+      , lexeme_(lexeme::none)
+      , key_(false)
+      , literal_(nullptr)
+      , unicode_(0u)
+      , hex_digits_(0u)
+      , high_surrogate_(0u)
+      , offset_(0u)
+      , code_(::rapidjson::kParseErrorNone) {}
+
+  // Prepares another document, the buffers are kept
+  void reset() {
+    containers_.clear();
+    buffer_.clear();
+    expect_ = expect::value;
+    lexeme_ = lexeme::none;
+    high_surrogate_ = 0u;
+    offset_ = 0u;
+    code_ = ::rapidjson::kParseErrorNone;
+  }
+
+  void reset(Handler& handler) {
+    handler_ = &handler;
+    reset();
+  }
+
+  // Parses a chunk of the document, from the end of the previous one. After
+  // a failure, the following chunks are ignored.
+  push_status feed(Ch const* data, size_t length) {
+    if (::rapidjson::kParseErrorNone != code_)
+      return push_status::failed;
+    size_t index = 0u;
+    while (index < length) {
+      Ch const c = data[index];
+      bool parsed = true;
+      switch (lexeme_) {
+      case lexeme::none:
+        if (!is_space(c))
+          parsed = token(c);
+        if (parsed)
+          ++index;
+        break;
+      case lexeme::string: {
+        size_t const begin = index;
+        if (high_surrogate_ && '\\' != c) {
+          parsed = fail(::rapidjson::kParseErrorStringUnicodeSurrogateInvalid);
+          break;
+        }
+        while (index < length && '"' != data[index] && '\\' != data[index] &&
+               0x20u <= static_cast<unsigned char>(data[index]))
+          ++index;
+        if (index == length) {
+          buffer_.append(data + begin, index - begin);
+        } else if ('"' == data[index]) {
+          // Not copied unless it spans several chunks or holds escapes
+          if (buffer_.empty()) {
+            parsed = emitString(data + begin, index - begin);
+          } else {
+            buffer_.append(data + begin, index - begin);
+            parsed = emitString(buffer_.data(), buffer_.size());
+          }
+          ++index;
+        } else if ('\\' == data[index]) {
+          buffer_.append(data + begin, index - begin);
+          lexeme_ = lexeme::escape;
+          ++index;
+        } else {
+          parsed = fail(::rapidjson::kParseErrorStringInvalidEncoding);
+        }
+      } break;
+      case lexeme::escape:
+        parsed = escape(c);
+        if (parsed)
+          ++index;
+        break;
+      case lexeme::unicode:
+        parsed = unicode(c);
+        if (parsed)
+          ++index;
+        break;
+      case lexeme::number:
+        if (is_number_part(c)) {
+          buffer_ += c;
+          ++index;
+        } else {
+          parsed = emitNumber();
+        }
+        break;
+      case lexeme::literal:
+        if (c != *literal_) {
+          parsed = fail(::rapidjson::kParseErrorValueInvalid);
+          break;
+        }
+        ++index;
+        if ('\0' == *++literal_)
+          parsed = emitLiteral();
+        break;
+      }
+      if (!parsed) {
+        offset_ += index;
+        return push_status::failed;
+      }
+    }
+    offset_ += length;
+    return status();
+  }
+
+  push_status feed(std::basic_string<Ch> const& chunk) {
+    return feed(chunk.data(), chunk.size());
+  }
+
+  // Ends the document, a number at its root is only complete there
+  push_status finish() {
+    if (::rapidjson::kParseErrorNone != code_)
+      return push_status::failed;
+    if (lexeme::number == lexeme_ && !emitNumber())
+      return push_status::failed;
+    if (push_status::complete == status())
+      return push_status::complete;
+
+    if (lexeme::none != lexeme_) {
+      fail(lexeme::literal == lexeme_
+               ? ::rapidjson::kParseErrorValueInvalid
+               : ::rapidjson::kParseErrorStringMissQuotationMark);
+    } else if (containers_.empty()) {
+      fail(::rapidjson::kParseErrorDocumentEmpty);
+    } else if (expect::colon == expect_) {
+      fail(::rapidjson::kParseErrorObjectMissColon);
+    } else if (expect::key == expect_ || expect::key_or_end_object == expect_) {
+      fail(::rapidjson::kParseErrorObjectMissName);
+    } else if (expect::comma_or_end != expect_) {
+      fail(::rapidjson::kParseErrorValueInvalid);
+    } else {
+      fail(containers_.back().object
+               ? ::rapidjson::kParseErrorObjectMissCommaOrCurlyBracket
+               : ::rapidjson::kParseErrorArrayMissCommaOrSquareBracket);
+    }
+    return push_status::failed;
+  }
+
+  // Bytes fed so far, or up to the first error
+  size_t offset() const { return offset_; }
+  ::rapidjson::ParseErrorCode code() const { return code_; }
+};
+
+template <class Handler>
+push_parser<Handler> make_push_parser(Handler& handler) {
+  return push_parser<Handler>(handler);
+}
+
+} // namespace rapidjson
+} // namespace extensions
+} // namespace named_types
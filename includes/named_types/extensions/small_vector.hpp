@@ -0,0 +1,162 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace named_types {
+
+// Sequence of at most Capacity elements stored inline, it never allocates.
+// push_back and emplace_back require room for one more element (see full()),
+// as asserted, parsers refuse the elements past the capacity and fail.
+template <class T, size_t Capacity> class small_vector {
+  using storage_type =
+      std::aligned_storage_t<sizeof(T), std::alignment_of<T>::value>;
+
+  storage_type storage_[Capacity ? Capacity : 1u];
+  size_t size_;
+
+ public:
+  using value_type = T;
+  using size_type = size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = T const&;
+  using pointer = T*;
+  using const_pointer = T const*;
+  using iterator = T*;
+  using const_iterator = T const*;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  small_vector() noexcept : size_(0u) {}
+
+  small_vector(std::initializer_list<T> values)
+      : size_(0u) {
+    for (T const& value : values)
+      push_back(value);
+  }
+
+  small_vector(small_vector const& other)
+      : size_(0u) {
+    for (T const& value : other)
+      push_back(value);
+  }
+
+  small_vector(small_vector&& other) noexcept(
+      std::is_nothrow_move_constructible<T>::value)
+      : size_(0u) {
+    for (T& value : other)
+      push_back(std::move(value));
+  }
+
+  ~small_vector() { clear(); }
+
+  small_vector& operator=(small_vector const& other) {
+    if (this != &other) {
+      size_t const common = std::min(size_, other.size_);
+      std::copy(other.begin(), other.begin() + common, begin());
+      erase(begin() + common, end());
+      for (size_t index = common; index < other.size_; ++index)
+        push_back(other[index]);
+    }
+    return *this;
+  }
+
+  small_vector& operator=(small_vector&& other) noexcept(
+      std::is_nothrow_move_assignable<T>::value &&
+          std::is_nothrow_move_constructible<T>::value) {
+    if (this != &other) {
+      size_t const common = std::min(size_, other.size_);
+      std::move(other.begin(), other.begin() + common, begin());
+      erase(begin() + common, end());
+      for (size_t index = common; index < other.size_; ++index)
+        push_back(std::move(other[index]));
+    }
+    return *this;
+  }
+
+  inline T* data() noexcept { return reinterpret_cast<T*>(storage_); }
+  inline T const* data() const noexcept {
+    return reinterpret_cast<T const*>(storage_);
+  }
+
+  inline iterator begin() noexcept { return data(); }
+  inline iterator end() noexcept { return data() + size_; }
+  inline const_iterator begin() const noexcept { return data(); }
+  inline const_iterator end() const noexcept { return data() + size_; }
+  inline const_iterator cbegin() const noexcept { return data(); }
+  inline const_iterator cend() const noexcept { return data() + size_; }
+  inline reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+  inline reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+  inline const_reverse_iterator rbegin() const noexcept {
+    return const_reverse_iterator(end());
+  }
+  inline const_reverse_iterator rend() const noexcept {
+    return const_reverse_iterator(begin());
+  }
+
+  inline size_t size() const noexcept { return size_; }
+  inline bool empty() const noexcept { return 0u == size_; }
+  inline bool full() const noexcept { return Capacity == size_; }
+  static constexpr size_t capacity() noexcept { return Capacity; }
+  static constexpr size_t max_size() noexcept { return Capacity; }
+
+  inline T& operator[](size_t index) { return data()[index]; }
+  inline T const& operator[](size_t index) const { return data()[index]; }
+  inline T& front() { return data()[0]; }
+  inline T const& front() const { return data()[0]; }
+  inline T& back() { return data()[size_ - 1u]; }
+  inline T const& back() const { return data()[size_ - 1u]; }
+
+  template <class... Args> inline T& emplace_back(Args&&... args) {
+    assert(size_ < Capacity);
+    T* element = new (data() + size_) T(std::forward<Args>(args)...);
+    ++size_;
+    return *element;
+  }
+
+  inline void push_back(T const& value) { emplace_back(value); }
+  inline void push_back(T&& value) { emplace_back(std::move(value)); }
+
+  inline void pop_back() { data()[--size_].~T(); }
+
+  inline void clear() noexcept {
+    while (size_)
+      data()[--size_].~T();
+  }
+
+  iterator erase(const_iterator first, const_iterator last) {
+    iterator const target = begin() + (first - cbegin());
+    if (first != last) {
+      iterator const moved_end =
+          std::move(begin() + (last - cbegin()), end(), target);
+      while (end() != moved_end)
+        pop_back();
+    }
+    return target;
+  }
+
+  inline iterator erase(const_iterator position) {
+    return erase(position, position + 1);
+  }
+};
+
+template <class T, size_t Capacity>
+inline bool operator==(small_vector<T, Capacity> const& left,
+                       small_vector<T, Capacity> const& right) {
+  return left.size() == right.size() &&
+         std::equal(left.begin(), left.end(), right.begin());
+}
+
+template <class T, size_t Capacity>
+inline bool operator!=(small_vector<T, Capacity> const& left,
+                       small_vector<T, Capacity> const& right) {
+  return !(left == right);
+}
+
+} // namespace named_types
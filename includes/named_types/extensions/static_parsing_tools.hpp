@@ -0,0 +1,608 @@
+#pragma once
+#include <type_traits>
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <string>
+#include <utility>
+#include "named_types/named_tuple.hpp"
+#include "named_types/perfect_hash.hpp"
+#include "named_types/extensions/type_traits.hpp"
+
+namespace named_types {
+namespace extensions {
+namespace parsing {
+
+// What parsers do with an object or an array having no destination, either
+// the value of an unknown key or of a field of another kind. Such unknown
+// scalars are always ignored.
+enum class unknown_keys { fail, skip };
+
+// What parsers do with the current content of their target. Merging appends
+// to sequences and keeps the existing entries of maps. Reusing builds the
+// value a default constructed target would get, in the memory of the current
+// one : elements of sequences are overwritten in place and the extra ones
+// erased, maps are cleared, fields an object does not set are reset.
+enum class parse_mode { merge, reuse };
+
+// Tuple of the given tags of a tuple, with the same types. Parsing into it,
+// with unknown keys skipped, only resolves these keys. Assigning it to the
+// whole tuple then injects the parsed values, other fields being untouched.
+template <class Tuple, class... Tags> struct projection {
+  using type = named_tuple<typename Tuple::template type_at<
+      typename named_tag<Tags>::type>::raw_type(Tags)...>;
+};
+
+template <class Tuple, class... Tags>
+using projection_t = typename projection<Tuple, Tags...>::type;
+
+// Type lists
+
+template <class... T> struct type_list {
+  static constexpr size_t size = sizeof...(T);
+};
+
+template <class T, class List, size_t Index = 0> struct type_list_index;
+
+template <class T, size_t Index>
+struct type_list_index<T, type_list<>, Index>
+    : std::integral_constant<size_t, Index> {};
+
+template <class T, class... Tail, size_t Index>
+struct type_list_index<T, type_list<T, Tail...>, Index>
+    : std::integral_constant<size_t, Index> {};
+
+template <class T, class Head, class... Tail, size_t Index>
+struct type_list_index<T, type_list<Head, Tail...>, Index>
+    : type_list_index<T, type_list<Tail...>, Index + 1> {};
+
+template <class T, class List>
+struct type_list_contains
+    : std::integral_constant<bool,
+                             type_list_index<T, List>::value < List::size> {};
+
+template <class... T> struct type_list_cat;
+
+template <class... T1, class... T2>
+struct type_list_cat<type_list<T1...>, type_list<T2...>> {
+  using type = type_list<T1..., T2...>;
+};
+
+// Schema : every sub element type reachable from a root type
+
+template <class T, class Enable = void> struct schema_children {
+  using type = type_list<>;
+};
+
+template <class... Tags> struct schema_children<named_tuple<Tags...>> {
+  using type = type_list<__ntuple_tag_elem_t<Tags>...>;
+};
+
+template <class T>
+struct schema_children<T,
+                       std::enable_if_t<is_sequence_container<T>::value>> {
+  using type = type_list<typename T::value_type>;
+};
+
+template <class T>
+struct schema_children<T,
+                       std::enable_if_t<is_associative_container<T>::value>> {
+  using type = type_list<typename T::mapped_type>;
+};
+
+template <class Visited, class Pending> struct __schema_closure;
+
+template <class... Visited>
+struct __schema_closure<type_list<Visited...>, type_list<>> {
+  using type = type_list<Visited...>;
+};
+
+template <class... Visited, class Head, class... Tail>
+struct __schema_closure<type_list<Visited...>, type_list<Head, Tail...>> {
+  using type = typename std::conditional_t<
+      !is_sub_element<Head>::value ||
+          type_list_contains<Head, type_list<Visited...>>::value,
+      __schema_closure<type_list<Visited...>, type_list<Tail...>>,
+      __schema_closure<
+          type_list<Visited..., Head>,
+          typename type_list_cat<typename schema_children<Head>::type,
+                                 type_list<Tail...>>::type>>::type;
+};
+
+template <class Root> struct schema_types {
+  using type =
+      typename __schema_closure<type_list<>, type_list<Root>>::type;
+};
+
+template <class Root> using schema_types_t = typename schema_types<Root>::type;
+
+// Calls the functor with the object typed after its index in the schema.
+// Dispatches go through a table of one function per type or field, built at
+// compile time : a lookup and an indirect call whatever the index. A last
+// null entry keeps the tables of empty lists valid.
+
+template <class Schema> struct schema_dispatch;
+
+template <class... Types> struct schema_dispatch<type_list<Types...>> {
+  template <class Result, class Func, class T>
+  static Result call(void* object, Func& func) {
+    return func(*static_cast<T*>(object));
+  }
+
+  template <class Result, class Func>
+  static inline Result apply(size_t type_index, void* object, Func&& func) {
+    using caller = Result (*)(void*, Func&);
+    static constexpr caller callers[] = {&call<Result, Func, Types>...,
+                                         nullptr};
+    return (type_index < sizeof...(Types) ? callers[type_index](object, func)
+                                          : Result{});
+  }
+};
+
+// Same dispatch on types only, the functor gets a type_tag
+
+template <class T> struct type_tag {
+  using type = T;
+};
+
+template <class Schema> struct schema_type_dispatch;
+
+template <class... Types> struct schema_type_dispatch<type_list<Types...>> {
+  template <class Result, class Func, class T>
+  static Result call(Func& func) {
+    return func(type_tag<T>{});
+  }
+
+  template <class Result, class Func>
+  static inline Result apply(size_t type_index, Func&& func) {
+    using caller = Result (*)(Func&);
+    static constexpr caller callers[] = {&call<Result, Func, Types>...,
+                                         nullptr};
+    return (type_index < sizeof...(Types) ? callers[type_index](func)
+                                          : Result{});
+  }
+};
+
+// Calls the functor with the field of the tuple at the given index
+
+template <class Tuple,
+          class Indices = std::make_index_sequence<Tuple::size>>
+struct field_dispatch;
+
+template <class Tuple, size_t... Indices>
+struct field_dispatch<Tuple, std::index_sequence<Indices...>> {
+  template <class Result, class Func, size_t Index>
+  static Result call(Tuple& tuple, Func& func) {
+    return func(std::get<Index>(tuple));
+  }
+
+  template <class Result, class Func>
+  static inline Result apply(Tuple& tuple, size_t field_index, Func&& func) {
+    using caller = Result (*)(Tuple&, Func&);
+    static constexpr caller callers[] = {&call<Result, Func, Indices>...,
+                                         nullptr};
+    return (field_index < sizeof...(Indices)
+                ? callers[field_index](tuple, func)
+                : Result{});
+  }
+};
+
+template <class Tuple,
+          class Indices = std::make_index_sequence<Tuple::size>>
+struct field_type_dispatch;
+
+template <class Tuple, size_t... Indices>
+struct field_type_dispatch<Tuple, std::index_sequence<Indices...>> {
+  template <class Result, class Func, size_t Index>
+  static Result call(Func& func) {
+    return func(type_tag<std::tuple_element_t<Index, Tuple>>{});
+  }
+
+  template <class Result, class Func>
+  static inline Result apply(size_t field_index, Func&& func) {
+    using caller = Result (*)(Func&);
+    static constexpr caller callers[] = {&call<Result, Func, Indices>...,
+                                         nullptr};
+    return (field_index < sizeof...(Indices) ? callers[field_index](func)
+                                             : Result{});
+  }
+};
+
+// Statically typed value conversions
+
+// A string given by a parser. Unless transient, data outlives the parsing
+// (in situ parsing) and can be referenced by string views.
+template <class CharT, class SizeType> struct string_value {
+  CharT const* data;
+  SizeType length;
+  bool transient;
+};
+
+template <class Target, class Source>
+inline std::enable_if_t<std::is_arithmetic<Source>::value &&
+                            std::is_arithmetic<Target>::value,
+                        bool>
+static_convert(Target& target, Source source) {
+  target = static_cast<Target>(source);
+  return true;
+}
+
+template <class Target, class Source>
+inline std::enable_if_t<std::is_arithmetic<Source>::value &&
+                            !std::is_arithmetic<Target>::value &&
+                            !is_std_basic_string<Target>::value &&
+                            std::is_assignable<Target&, Source>::value,
+                        bool>
+static_convert(Target& target, Source source) {
+  target = source;
+  return true;
+}
+
+template <class Target, class Source>
+inline std::enable_if_t<std::is_arithmetic<Source>::value &&
+                            !std::is_arithmetic<Target>::value &&
+                            (is_std_basic_string<Target>::value ||
+                             !std::is_assignable<Target&, Source>::value),
+                        bool>
+static_convert(Target&, Source) {
+  return false;
+}
+
+template <class Target>
+inline std::enable_if_t<
+    std::is_assignable<Target&, std::nullptr_t>::value &&
+        !is_null_into_string<Target, std::nullptr_t>::value,
+    bool>
+static_convert(Target& target, std::nullptr_t) {
+  target = nullptr;
+  return true;
+}
+
+template <class Target>
+inline std::enable_if_t<
+    !std::is_assignable<Target&, std::nullptr_t>::value ||
+        is_null_into_string<Target, std::nullptr_t>::value,
+    bool>
+static_convert(Target&, std::nullptr_t) {
+  return false;
+}
+
+template <class Target, class CharT, class SizeType>
+inline std::enable_if_t<
+    std::is_same<std::basic_string<CharT>, Target>::value,
+    bool>
+static_convert(Target& target, string_value<CharT, SizeType> source) {
+  target.assign(source.data, source.length);
+  return true;
+}
+
+template <class Target, class CharT, class SizeType>
+inline std::enable_if_t<is_string_view<Target>::value, bool>
+static_convert(Target& target, string_value<CharT, SizeType> source) {
+  if (source.transient)
+    return false;
+  target = Target(source.data, source.length);
+  return true;
+}
+
+template <class Target, class CharT, class SizeType>
+inline std::enable_if_t<
+    !std::is_same<std::basic_string<CharT>, Target>::value &&
+        !is_string_view<Target>::value &&
+        std::is_assignable<Target&, std::basic_string<CharT>>::value,
+    bool>
+static_convert(Target& target, string_value<CharT, SizeType> source) {
+  target = std::basic_string<CharT>(source.data, source.length);
+  return true;
+}
+
+template <class Target, class CharT, class SizeType>
+inline std::enable_if_t<
+    !std::is_same<std::basic_string<CharT>, Target>::value &&
+        !is_string_view<Target>::value &&
+        !std::is_assignable<Target&, std::basic_string<CharT>>::value,
+    bool>
+static_convert(Target&, string_value<CharT, SizeType>) {
+  return false;
+}
+
+// Whether a value of type Source is accepted by a member of type Target, as
+// static_convert would assign it. Strings are given as std::basic_string, they
+// are also accepted by string views, and are the only values accepted by
+// strings.
+template <class Source, class Target>
+struct value_accepted
+    : std::integral_constant<
+          bool,
+          is_std_basic_string<Target>::value
+              ? is_std_basic_string<Source>::value
+              : tuple_member_assignable<Source, std::tuple<Target>, 0>::value ||
+                    tuple_member_static_cast_assignable<
+                        Source, std::tuple<Target>, 0>::value ||
+                    (is_std_basic_string<Source>::value &&
+                     is_string_view<Target>::value)> {};
+
+// Insertions into the containers being parsed, to be specialized for the
+// custom containers of is_sequence_container or is_associative_container.
+// start and finish surround the elements of each parsed array or object, so
+// that a container can collect them and sort or index them once.
+
+template <class T, class Enable = void>
+struct __has_reserve : std::integral_constant<bool, false> {};
+
+template <class T>
+struct __has_reserve<T,
+                     decltype(std::declval<T&>().reserve(std::size_t{}))>
+    : std::integral_constant<bool, true> {};
+
+template <class T>
+inline std::enable_if_t<__has_reserve<T>::value> __reserve(T& container,
+                                                            size_t size) {
+  container.reserve(size);
+}
+
+template <class T>
+inline std::enable_if_t<!__has_reserve<T>::value> __reserve(T&, size_t) {}
+
+template <class Container> struct sequence_inserter {
+  static inline void start(Container&) {}
+
+  // Room for size elements, when the parser knows it beforehand
+  static inline void reserve(Container& container, size_t size) {
+    __reserve(container, size);
+  }
+
+  // Appends a default constructed element and returns it
+  static inline typename Container::reference element(Container& container) {
+    container.emplace_back();
+    return container.back();
+  }
+
+  static inline void append(Container& container,
+                            typename Container::value_type&& value) {
+    container.push_back(std::move(value));
+  }
+
+  static inline void finish(Container&) {}
+};
+
+template <class Container> struct associative_inserter {
+  using key_type = typename Container::key_type;
+  using mapped_type = typename Container::mapped_type;
+
+  static inline void start(Container&) {}
+
+  // Value inserted for a new key, nullptr for a duplicate one. It stays valid
+  // until the next insertion.
+  static inline mapped_type* emplace(Container& container,
+                                     key_type key,
+                                     mapped_type&& value) {
+    auto inserted = container.emplace(std::move(key), std::move(value));
+    return inserted.second ? &inserted.first->second : nullptr;
+  }
+
+  static inline void finish(Container&) {}
+};
+
+// Target reuse
+
+template <class T, class Enable = void>
+struct __has_clear : std::integral_constant<bool, false> {};
+
+template <class T>
+struct __has_clear<T, decltype(std::declval<T&>().clear())>
+    : std::integral_constant<bool, true> {};
+
+template <class T>
+inline std::enable_if_t<__has_clear<T>::value> __reuse_reset(T& value);
+template <class... Tags>
+inline void __reuse_reset(named_tuple<Tags...>& value);
+template <class T>
+inline std::enable_if_t<!__has_clear<T>::value && !is_named_tuple<T>::value>
+__reuse_reset(T& value);
+
+template <class Tuple, class Seen, size_t... Index>
+inline void __reset_unseen_fields(Tuple& tuple,
+                                  Seen const& seen,
+                                  std::index_sequence<Index...>) {
+  int expand[] = {
+      0, (seen(Index) ? 0 : (__reuse_reset(std::get<Index>(tuple)), 0))...};
+  (void)expand;
+}
+
+// Resets the fields of the tuple for which seen(index) is false
+template <class Seen, class... Tags>
+inline void reset_unseen_fields(named_tuple<Tags...>& tuple, Seen const& seen) {
+  __reset_unseen_fields(tuple, seen,
+                        std::make_index_sequence<sizeof...(Tags)>());
+}
+
+template <class T>
+inline std::enable_if_t<__has_clear<T>::value> __reuse_reset(T& value) {
+  value.clear();
+}
+
+template <class... Tags>
+inline void __reuse_reset(named_tuple<Tags...>& value) {
+  reset_unseen_fields(value, [](size_t) { return false; });
+}
+
+template <class T>
+inline std::enable_if_t<!__has_clear<T>::value && !is_named_tuple<T>::value>
+__reuse_reset(T& value) {
+  value = T{};
+}
+
+// Sequences being reused : the element at a given index is overwritten when
+// it exists and appended otherwise. Vectors are indexed, lists move each
+// reused element to their back, their stale elements remaining in front.
+
+template <class Container>
+inline typename Container::reference __reuse_element(Container& container,
+                                                     size_t index) {
+  if (index < container.size())
+    return *std::next(container.begin(), static_cast<std::ptrdiff_t>(index));
+  return sequence_inserter<Container>::element(container);
+}
+
+template <class T, class Allocator>
+inline T& __reuse_element(std::list<T, Allocator>& container, size_t index) {
+  if (index < container.size())
+    container.splice(container.end(), container, container.begin());
+  else
+    container.emplace_back();
+  return container.back();
+}
+
+template <class Container, class Value>
+inline bool __reuse_convert(Container& container, size_t index, Value value) {
+  if (index < container.size()) {
+    auto&& element =
+        *std::next(container.begin(), static_cast<std::ptrdiff_t>(index));
+    return static_convert(element, value);
+  }
+  typename Container::value_type element{};
+  if (!static_convert(element, value))
+    return false;
+  sequence_inserter<Container>::append(container, std::move(element));
+  return true;
+}
+
+template <class T, class Allocator, class Value>
+inline bool __reuse_convert(std::list<T, Allocator>& container,
+                            size_t index,
+                            Value value) {
+  if (index < container.size()) {
+    if (!static_convert(container.front(), value))
+      return false;
+    container.splice(container.end(), container, container.begin());
+    return true;
+  }
+  T element{};
+  if (!static_convert(element, value))
+    return false;
+  container.push_back(std::move(element));
+  return true;
+}
+
+// Erases the elements past the given count
+template <class Container>
+inline void __reuse_truncate(Container& container, size_t count) {
+  if (count < container.size())
+    container.erase(
+        std::next(container.begin(), static_cast<std::ptrdiff_t>(count)),
+        container.end());
+}
+
+template <class T, class Allocator>
+inline void __reuse_truncate(std::list<T, Allocator>& container, size_t count) {
+  if (count < container.size())
+    container.erase(container.begin(),
+                    std::next(container.begin(), static_cast<std::ptrdiff_t>(
+                                                     container.size() - count)));
+}
+
+// Sequences being parsed, count being the number of elements parsed so far.
+// Merging appends, reusing overwrites the existing elements first, arrays
+// are filled by position in both modes. Once a sequence of fixed capacity is
+// full, one more element fails the parsing.
+
+template <class Container>
+inline bool __sequence_full(Container const&, size_t, parse_mode) {
+  return false;
+}
+
+template <class T, size_t Size>
+inline bool __sequence_full(std::array<T, Size> const&,
+                            size_t count,
+                            parse_mode) {
+  return Size <= count;
+}
+
+template <class T, size_t Capacity>
+inline bool __sequence_full(small_vector<T, Capacity> const& container,
+                            size_t count,
+                            parse_mode mode) {
+  return parse_mode::reuse == mode ? Capacity <= count : container.full();
+}
+
+template <class Container>
+inline typename Container::reference __append_element(Container& container,
+                                                      size_t& count,
+                                                      parse_mode mode) {
+  if (parse_mode::reuse == mode)
+    return __reuse_element(container, count++);
+  ++count;
+  return sequence_inserter<Container>::element(container);
+}
+
+template <class T, size_t Size>
+inline T& __append_element(std::array<T, Size>& container,
+                           size_t& count,
+                           parse_mode) {
+  return container[count++];
+}
+
+template <class Container, class Value>
+inline bool __append_convert(Container& container,
+                             size_t& count,
+                             parse_mode mode,
+                             Value value) {
+  if (parse_mode::reuse == mode) {
+    if (!__reuse_convert(container, count, value))
+      return false;
+  } else {
+    typename Container::value_type element{};
+    if (!static_convert(element, value))
+      return false;
+    sequence_inserter<Container>::append(container, std::move(element));
+  }
+  ++count;
+  return true;
+}
+
+template <class T, size_t Size, class Value>
+inline bool __append_convert(std::array<T, Size>& container,
+                             size_t& count,
+                             parse_mode,
+                             Value value) {
+  if (!static_convert(container[count], value))
+    return false;
+  ++count;
+  return true;
+}
+
+// Room for count parsed elements, appended or overwriting the existing ones
+template <class Container>
+inline void __reserve_sequence(Container& container,
+                               size_t count,
+                               parse_mode mode) {
+  sequence_inserter<Container>::reserve(
+      container,
+      parse_mode::reuse == mode ? count : container.size() + count);
+}
+
+// Reused sequences lose the elements not overwritten, arrays reset them
+template <class Container>
+inline void __end_sequence(Container& container,
+                           size_t count,
+                           parse_mode mode) {
+  if (parse_mode::reuse == mode)
+    __reuse_truncate(container, count);
+  sequence_inserter<Container>::finish(container);
+}
+
+template <class T, size_t Size>
+inline void __end_sequence(std::array<T, Size>& container,
+                           size_t count,
+                           parse_mode mode) {
+  if (parse_mode::reuse == mode) {
+    for (; count < Size; ++count)
+      __reuse_reset(container[count]);
+  }
+}
+
+} // namespace parsing
+} // namespace extensions
+} // namespace named_types
@@ -0,0 +1,991 @@
+#pragma once
+#include <type_traits>
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#if defined(NAMED_TYPES_NO_SIMD)
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include "named_types/named_tuple.hpp"
+#include "named_types/perfect_hash.hpp"
+#include "named_types/extensions/type_traits.hpp"
+#include "named_types/extensions/number_tools.hpp"
+#include "named_types/extensions/static_parsing_tools.hpp"
+
+namespace named_types {
+namespace extensions {
+namespace parsing {
+
+// JSON parser in two stages, without SAX events.
+// The first stage indexes the positions of the structural characters of the
+// input (braces, brackets, colons, commas, string and scalar starts) 64 bytes
+// at a time, with SIMD compares when available. The second stage walks this
+// index following the static schema of the target, writing values directly
+// into its fields.
+// Defining NAMED_TYPES_NO_SIMD selects the portable first stage.
+
+enum class structural_error {
+  none,
+  too_large,
+  empty_document,
+  invalid_root,
+  not_singular,
+  unterminated_string,
+  invalid_string_char,
+  invalid_escape,
+  invalid_value,
+  invalid_number,
+  number_too_big,
+  missing_name,
+  missing_colon,
+  missing_comma_or_end,
+  unexpected_value,
+  too_deep,
+  too_many_elements
+};
+
+// Whether arrays are first counted on the structural index, so that the
+// sequences able to reserve get their final capacity before being filled
+// instead of moving their elements at each growth. It costs one more walk
+// over the index of each array.
+enum class array_sizing { grow, prescan };
+
+struct structural_result {
+  structural_error error;
+  size_t offset;
+  explicit operator bool() const { return structural_error::none == error; }
+};
+
+// Bit masks of one block of 64 bytes
+
+struct __json_block {
+  uint64_t quote;
+  uint64_t backslash;
+  uint64_t op;
+  uint64_t whitespace;
+  uint64_t control;
+};
+
+#if defined(NAMED_TYPES_NO_SIMD)
+#elif defined(__AVX2__)
+inline __json_block __json_classify(char const* input) {
+  __json_block block{0u, 0u, 0u, 0u, 0u};
+  for (size_t half = 0; half < 2u; ++half) {
+    __m256i chunk = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const*>(input + 32u * half));
+    __m256i lowered = _mm256_or_si256(chunk, _mm256_set1_epi8(0x20));
+    auto eq = [](__m256i value, char c) {
+      return _mm256_cmpeq_epi8(value, _mm256_set1_epi8(c));
+    };
+    auto bits = [half](__m256i value) {
+      return static_cast<uint64_t>(
+                 static_cast<uint32_t>(_mm256_movemask_epi8(value)))
+             << (32u * half);
+    };
+    block.quote |= bits(eq(chunk, '"'));
+    block.backslash |= bits(eq(chunk, '\\'));
+    block.op |= bits(_mm256_or_si256(
+        _mm256_or_si256(eq(lowered, '{'), eq(lowered, '}')),
+        _mm256_or_si256(eq(chunk, ':'), eq(chunk, ','))));
+    block.whitespace |= bits(
+        _mm256_or_si256(_mm256_or_si256(eq(chunk, ' '), eq(chunk, '\t')),
+                        _mm256_or_si256(eq(chunk, '\n'), eq(chunk, '\r'))));
+    block.control |= bits(_mm256_cmpeq_epi8(
+        _mm256_min_epu8(chunk, _mm256_set1_epi8(0x1f)), chunk));
+  }
+  return block;
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+inline __json_block __json_classify(char const* input) {
+  __json_block block{0u, 0u, 0u, 0u, 0u};
+  for (size_t quarter = 0; quarter < 4u; ++quarter) {
+    __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(input + 16u * quarter));
+    __m128i lowered = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+    auto eq = [](__m128i value, char c) {
+      return _mm_cmpeq_epi8(value, _mm_set1_epi8(c));
+    };
+    auto bits = [quarter](__m128i value) {
+      return static_cast<uint64_t>(
+                 static_cast<uint32_t>(_mm_movemask_epi8(value)))
+             << (16u * quarter);
+    };
+    block.quote |= bits(eq(chunk, '"'));
+    block.backslash |= bits(eq(chunk, '\\'));
+    block.op |= bits(
+        _mm_or_si128(_mm_or_si128(eq(lowered, '{'), eq(lowered, '}')),
+                     _mm_or_si128(eq(chunk, ':'), eq(chunk, ','))));
+    block.whitespace |=
+        bits(_mm_or_si128(_mm_or_si128(eq(chunk, ' '), eq(chunk, '\t')),
+                          _mm_or_si128(eq(chunk, '\n'), eq(chunk, '\r'))));
+    block.control |= bits(
+        _mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1f)), chunk));
+  }
+  return block;
+}
+#endif
+#if defined(NAMED_TYPES_NO_SIMD) || \
+    !(defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64))
+inline __json_block __json_classify(char const* input) {
+  __json_block block{0u, 0u, 0u, 0u, 0u};
+  for (size_t index = 0; index < 64u; ++index) {
+    uint64_t bit = uint64_t(1u) << index;
+    unsigned char value = static_cast<unsigned char>(input[index]);
+    switch (value) {
+    case '"':
+      block.quote |= bit;
+      break;
+    case '\\':
+      block.backslash |= bit;
+      break;
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',':
+      block.op |= bit;
+      break;
+    case ' ':
+      block.whitespace |= bit;
+      break;
+    case '\t':
+    case '\n':
+    case '\r':
+      block.whitespace |= bit;
+      block.control |= bit;
+      break;
+    default:
+      if (value < 0x20u)
+        block.control |= bit;
+    }
+  }
+  return block;
+}
+#endif
+
+inline size_t __trailing_zeros(uint64_t value) {
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward64(&index, value);
+  return index;
+#else
+  return static_cast<size_t>(__builtin_ctzll(value));
+#endif
+}
+
+// Characters escaped by a backslash, odd sequences of backslashes escaping
+// the character following them. The carry tells if the first character of
+// the next block is escaped.
+inline uint64_t __json_escaped(uint64_t backslash, uint64_t& carry) {
+  backslash &= ~carry;
+  uint64_t follows_escape = backslash << 1u | carry;
+  uint64_t const even_bits = 0x5555555555555555llu;
+  uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+  uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+  carry = sequences_starting_on_even_bits < backslash ? 1u : 0u;
+  uint64_t invert_mask = sequences_starting_on_even_bits << 1u;
+  return (even_bits ^ invert_mask) & follows_escape;
+}
+
+// Bit i is the parity of the bits 0 to i
+inline uint64_t __json_prefix_xor(uint64_t value) {
+  value ^= value << 1u;
+  value ^= value << 2u;
+  value ^= value << 4u;
+  value ^= value << 8u;
+  value ^= value << 16u;
+  value ^= value << 32u;
+  return value;
+}
+
+// Positions of the structural characters, ended by the input length. Its
+// storage is kept from an input to another.
+class structural_index {
+  std::unique_ptr<uint32_t[]> positions_;
+  size_t size_;
+  size_t capacity_;
+
+ public:
+  structural_index()
+      : positions_()
+      , size_(0u)
+      , capacity_(0u) {}
+
+  structural_result build(char const* data, size_t length) {
+    if (UINT32_MAX <= length)
+      return {structural_error::too_large, 0u};
+    if (capacity_ < length + 1u) {
+      positions_.reset(new uint32_t[length + 1u]);
+      capacity_ = length + 1u;
+    }
+
+    uint32_t* out = positions_.get();
+    uint64_t escape_carry = 0u;
+    uint64_t in_string_carry = 0u;
+    uint64_t scalar_carry = 0u;
+    char tail[64];
+    for (size_t base = 0; base < length; base += 64u) {
+      char const* input = data + base;
+      if (length - base < 64u) {
+        std::memset(tail, ' ', 64u);
+        std::memcpy(tail, input, length - base);
+        input = tail;
+      }
+      __json_block block = __json_classify(input);
+
+      uint64_t quote = block.quote & ~__json_escaped(block.backslash, escape_carry);
+      uint64_t in_string = __json_prefix_xor(quote) ^ in_string_carry;
+      in_string_carry =
+          static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+      if (block.control & in_string) {
+        return {structural_error::invalid_string_char,
+                base + __trailing_zeros(block.control & in_string)};
+      }
+
+      uint64_t scalar = ~(block.op | block.whitespace | quote) & ~in_string;
+      uint64_t structurals = (block.op & ~in_string) | (quote & in_string) |
+                             (scalar & ~(scalar << 1u | scalar_carry));
+      scalar_carry = scalar >> 63u;
+
+      while (structurals) {
+        *out++ = static_cast<uint32_t>(base + __trailing_zeros(structurals));
+        structurals &= structurals - 1u;
+      }
+    }
+    if (in_string_carry)
+      return {structural_error::unterminated_string, length};
+
+    *out++ = static_cast<uint32_t>(length);
+    size_ = static_cast<size_t>(out - positions_.get());
+    return {structural_error::none, 0u};
+  }
+
+  inline size_t size() const { return size_; }
+  inline uint32_t operator[](size_t index) const { return positions_[index]; }
+};
+
+// Target of the values with no field
+struct __ignored_value {};
+
+// Next element of a sequence, converted scalars are appended or overwrite it
+template <class Container> struct __append_slot {
+  Container& container;
+  size_t& count;
+  parse_mode mode;
+};
+
+// Insertion hooks of the associative containers around their members
+template <class T>
+inline std::enable_if_t<!is_associative_container<T>::value> __start_members(
+    T&) {}
+
+template <class T>
+inline std::enable_if_t<is_associative_container<T>::value> __start_members(
+    T& target) {
+  associative_inserter<T>::start(target);
+}
+
+template <class T>
+inline std::enable_if_t<!is_associative_container<T>::value> __finish_members(
+    T&) {}
+
+template <class T>
+inline std::enable_if_t<is_associative_container<T>::value> __finish_members(
+    T& target) {
+  associative_inserter<T>::finish(target);
+}
+
+// Fields of a tuple set by an object, the others are reset when reusing
+template <class T> struct __set_fields {
+  inline void set(size_t) {}
+  inline void reset_others(T&) const {}
+};
+
+template <class... Tags> struct __set_fields<named_tuple<Tags...>> {
+  std::bitset<sizeof...(Tags)> fields;
+
+  inline void set(size_t index) { fields.set(index); }
+  inline void reset_others(named_tuple<Tags...>& tuple) const {
+    reset_unseen_fields(tuple, [this](size_t index) { return fields[index]; });
+  }
+};
+
+inline bool __json_whitespace(char value) {
+  return ' ' == value || '\n' == value || '\r' == value || '\t' == value;
+}
+
+inline bool __json_digit(char value) { return '0' <= value && value <= '9'; }
+
+class structural_parser {
+  structural_index index_;
+  std::string key_scratch_;
+  std::string value_scratch_;
+  char const* data_;
+  size_t length_;
+  size_t cursor_;
+  size_t depth_;
+  unknown_keys unknown_keys_;
+  parse_mode mode_;
+  array_sizing sizing_;
+  structural_result result_;
+
+  inline size_t position() const { return index_[cursor_]; }
+
+  inline char token() const {
+    return position() < length_ ? data_[position()] : '\0';
+  }
+
+  // Token end, trailing whitespaces excluded. The end of input marker is
+  // the last position, its token is empty.
+  inline char const* token_end() const {
+    char const* begin = data_ + position();
+    if (index_.size() <= cursor_ + 1u)
+      return begin;
+    char const* end = data_ + index_[cursor_ + 1u];
+    while (begin < end && __json_whitespace(end[-1]))
+      --end;
+    return end;
+  }
+
+  inline bool fail(structural_error error) {
+    result_ = {error, position()};
+    return false;
+  }
+
+  // Strings
+
+  static inline int hex_value(char value) {
+    return '0' <= value && value <= '9'
+               ? value - '0'
+               : 'a' <= value && value <= 'f'
+                     ? value - 'a' + 10
+                     : 'A' <= value && value <= 'F' ? value - 'A' + 10 : -1;
+  }
+
+  static inline bool read_code_unit(char const*& cursor,
+                                    char const* end,
+                                    uint32_t& code) {
+    if (end - cursor < 4)
+      return false;
+    code = 0u;
+    for (size_t index = 0; index < 4u; ++index) {
+      int digit = hex_value(*cursor++);
+      if (digit < 0)
+        return false;
+      code = code << 4u | static_cast<uint32_t>(digit);
+    }
+    return true;
+  }
+
+  static inline void append_utf8(std::string& output, uint32_t code) {
+    if (code < 0x80u) {
+      output += static_cast<char>(code);
+    } else if (code < 0x800u) {
+      output += static_cast<char>(0xc0u | code >> 6u);
+      output += static_cast<char>(0x80u | (code & 0x3fu));
+    } else if (code < 0x10000u) {
+      output += static_cast<char>(0xe0u | code >> 12u);
+      output += static_cast<char>(0x80u | (code >> 6u & 0x3fu));
+      output += static_cast<char>(0x80u | (code & 0x3fu));
+    } else {
+      output += static_cast<char>(0xf0u | code >> 18u);
+      output += static_cast<char>(0x80u | (code >> 12u & 0x3fu));
+      output += static_cast<char>(0x80u | (code >> 6u & 0x3fu));
+      output += static_cast<char>(0x80u | (code & 0x3fu));
+    }
+  }
+
+  bool unescape(char const* cursor, char const* end, std::string& output) {
+    output.clear();
+    while (cursor < end) {
+      char const* backslash = static_cast<char const*>(
+          std::memchr(cursor, '\\', static_cast<size_t>(end - cursor)));
+      if (!backslash) {
+        output.append(cursor, end);
+        break;
+      }
+      output.append(cursor, backslash);
+      cursor = backslash + 1;
+      switch (*cursor++) {
+      case '"':
+        output += '"';
+        break;
+      case '\\':
+        output += '\\';
+        break;
+      case '/':
+        output += '/';
+        break;
+      case 'b':
+        output += '\b';
+        break;
+      case 'f':
+        output += '\f';
+        break;
+      case 'n':
+        output += '\n';
+        break;
+      case 'r':
+        output += '\r';
+        break;
+      case 't':
+        output += '\t';
+        break;
+      case 'u': {
+        uint32_t code = 0u;
+        if (!read_code_unit(cursor, end, code))
+          return fail(structural_error::invalid_escape);
+        if (0xd800u <= code && code < 0xdc00u) {
+          uint32_t low = 0u;
+          if (end - cursor < 6 || '\\' != cursor[0] || 'u' != cursor[1])
+            return fail(structural_error::invalid_escape);
+          cursor += 2;
+          if (!read_code_unit(cursor, end, low) || low < 0xdc00u ||
+              0xe000u <= low)
+            return fail(structural_error::invalid_escape);
+          code = 0x10000u + ((code - 0xd800u) << 10u) + (low - 0xdc00u);
+        } else if (0xdc00u <= code && code < 0xe000u) {
+          return fail(structural_error::invalid_escape);
+        }
+        append_utf8(output, code);
+        break;
+      }
+      default:
+        return fail(structural_error::invalid_escape);
+      }
+    }
+    return true;
+  }
+
+  // The closing quote is the last character of the token. Strings with no
+  // escape sequence point into the input and are not transient.
+  bool string(string_value<char, size_t>& value, std::string& scratch) {
+    char const* begin = data_ + position() + 1;
+    char const* end = token_end() - 1;
+    if (std::memchr(begin, '\\', static_cast<size_t>(end - begin))) {
+      if (!unescape(begin, end, scratch))
+        return false;
+      value = {scratch.data(), scratch.size(), true};
+    } else {
+      value = {begin, static_cast<size_t>(end - begin), false};
+    }
+    return true;
+  }
+
+  // Scalars
+
+  template <class T, class Value>
+  static inline bool convert(T& target, Value value) {
+    return static_convert(target, value);
+  }
+
+  template <class Container, class Value>
+  static inline bool convert(__append_slot<Container>& slot, Value value) {
+    return __append_convert(slot.container, slot.count, slot.mode, value);
+  }
+
+  template <class T>
+  bool number(char const* begin,
+              char const* end,
+              T& target,
+              bool& converted) {
+    char const* cursor = begin;
+    bool negative = '-' == *cursor;
+    if (negative)
+      ++cursor;
+    char const* digits = cursor;
+    uint64_t integer = 0u;
+    if (cursor == end || !__json_digit(*cursor))
+      return fail(structural_error::invalid_value);
+    if ('0' == *cursor) {
+      ++cursor;
+    } else {
+      while (cursor < end && __json_digit(*cursor))
+        integer = 10u * integer + static_cast<uint64_t>(*cursor++ - '0');
+    }
+    size_t digit_count = static_cast<size_t>(cursor - digits);
+    bool is_integer = true;
+    if (cursor < end && '.' == *cursor) {
+      is_integer = false;
+      if (++cursor == end || !__json_digit(*cursor))
+        return fail(structural_error::invalid_number);
+      while (cursor < end && __json_digit(*cursor))
+        ++cursor;
+    }
+    if (cursor < end && ('e' == *cursor || 'E' == *cursor)) {
+      is_integer = false;
+      if (++cursor < end && ('+' == *cursor || '-' == *cursor))
+        ++cursor;
+      if (cursor == end || !__json_digit(*cursor))
+        return fail(structural_error::invalid_number);
+      while (cursor < end && __json_digit(*cursor))
+        ++cursor;
+    }
+    if (cursor != end)
+      return fail(structural_error::invalid_number);
+
+    // 20 digits integers fit if their first 19 digits do not overflow
+    // when multiplied by ten
+    bool fits = digit_count < 20u;
+    if (20u == digit_count) {
+      uint64_t head = 0u;
+      for (size_t index = 0; index < 19u; ++index)
+        head = 10u * head + static_cast<uint64_t>(digits[index] - '0');
+      fits = head < 1844674407370955161llu ||
+             (1844674407370955161llu == head && digits[19] <= '5');
+    }
+    if (is_integer && fits) {
+      if (!negative) {
+        converted = convert(target, integer);
+        return true;
+      }
+      if (integer <= 9223372036854775808llu) {
+        converted = convert(
+            target, 9223372036854775808llu == integer
+                        ? -9223372036854775807ll - 1
+                        : -static_cast<int64_t>(integer));
+        return true;
+      }
+    }
+    // Out of integer range, or floating point
+    char buffer[64];
+    std::string long_buffer;
+    char const* text = buffer;
+    size_t length = static_cast<size_t>(end - begin);
+    if (length < sizeof(buffer)) {
+      std::memcpy(buffer, begin, length);
+      buffer[length] = '\0';
+    } else {
+      long_buffer.assign(begin, end);
+      text = long_buffer.c_str();
+    }
+    double const number = __c_read<double>(text, nullptr);
+    if (std::isinf(number))
+      return fail(structural_error::number_too_big);
+    converted = convert(target, number);
+    return true;
+  }
+
+  template <class T> bool scalar(T& target, bool& converted) {
+    char const* begin = data_ + position();
+    char const* end = token_end();
+    switch (token()) {
+    case '"': {
+      string_value<char, size_t> value{nullptr, 0u, false};
+      if (!string(value, value_scratch_))
+        return false;
+      converted = convert(target, value);
+      break;
+    }
+    case 't':
+      if (!is_literal(begin, end, "true", 4u))
+        return fail(structural_error::invalid_value);
+      converted = convert(target, true);
+      break;
+    case 'f':
+      if (!is_literal(begin, end, "false", 5u))
+        return fail(structural_error::invalid_value);
+      converted = convert(target, false);
+      break;
+    case 'n':
+      if (!is_literal(begin, end, "null", 4u))
+        return fail(structural_error::invalid_value);
+      converted = convert(target, nullptr);
+      break;
+    case '\0':
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',':
+      return fail(structural_error::invalid_value);
+    default:
+      if (!number(begin, end, target, converted))
+        return false;
+    }
+    ++cursor_;
+    return true;
+  }
+
+  // Values : objects and arrays are only accepted by matching targets,
+  // others are skipped. Skipped values are walked on the index without being
+  // converted : their brackets must match, their members be named, and their
+  // scalars be strings, literals or start like numbers.
+
+  bool unplaced() {
+    if (unknown_keys::skip != unknown_keys_)
+      return fail(structural_error::unexpected_value);
+    return skip();
+  }
+
+  bool skip() {
+    switch (token()) {
+    case '{':
+      return skip_container('}', true);
+    case '[':
+      return skip_container(']', false);
+    default:
+      return skip_scalar();
+    }
+  }
+
+  bool skip_container(char close, bool named) {
+    if (max_depth < ++depth_)
+      return fail(structural_error::too_deep);
+    ++cursor_;
+    if (close == token()) {
+      ++cursor_;
+    } else {
+      for (;;) {
+        if (named) {
+          if ('"' != token())
+            return fail(structural_error::missing_name);
+          ++cursor_;
+          if (':' != token())
+            return fail(structural_error::missing_colon);
+          ++cursor_;
+        }
+        if (!skip())
+          return false;
+        char next = token();
+        ++cursor_;
+        if (',' == next)
+          continue;
+        if (close == next)
+          break;
+        --cursor_;
+        return fail(structural_error::missing_comma_or_end);
+      }
+    }
+    --depth_;
+    return true;
+  }
+
+  static inline bool is_literal(char const* begin,
+                                char const* end,
+                                char const* literal,
+                                size_t length) {
+    return static_cast<size_t>(end - begin) == length &&
+           0 == std::memcmp(begin, literal, length);
+  }
+
+  bool skip_scalar() {
+    char const* begin = data_ + position();
+    char const* end = token_end();
+    switch (token()) {
+    case '"':
+      break;
+    case 't':
+      if (!is_literal(begin, end, "true", 4u))
+        return fail(structural_error::invalid_value);
+      break;
+    case 'f':
+      if (!is_literal(begin, end, "false", 5u))
+        return fail(structural_error::invalid_value);
+      break;
+    case 'n':
+      if (!is_literal(begin, end, "null", 4u))
+        return fail(structural_error::invalid_value);
+      break;
+    default:
+      if ('-' != token() && !__json_digit(token()))
+        return fail(structural_error::invalid_value);
+    }
+    ++cursor_;
+    return true;
+  }
+
+  template <class T> bool value(T& target) {
+    switch (token()) {
+    case '{':
+      return object(target);
+    case '[':
+      return array(target);
+    default: {
+      bool converted = false;
+      return scalar(target, converted);
+    }
+    }
+  }
+
+  template <class T>
+  std::enable_if_t<is_sub_object<T>::value, bool> object(T& target) {
+    if (max_depth < ++depth_)
+      return fail(structural_error::too_deep);
+    bool const reuse = parse_mode::reuse == mode_;
+    if (reuse && is_associative_container<T>::value)
+      __reuse_reset(target);
+    __start_members(target);
+    __set_fields<T> fields;
+    ++cursor_;
+    if ('}' == token()) {
+      ++cursor_;
+    } else {
+      for (;;) {
+        string_value<char, size_t> key{nullptr, 0u, false};
+        if ('"' != token())
+          return fail(structural_error::missing_name);
+        if (!string(key, key_scratch_))
+          return false;
+        ++cursor_;
+        if (':' != token())
+          return fail(structural_error::missing_colon);
+        ++cursor_;
+        if (!member(target, key, fields))
+          return false;
+        char next = token();
+        ++cursor_;
+        if (',' == next)
+          continue;
+        if ('}' == next)
+          break;
+        --cursor_;
+        return fail(structural_error::missing_comma_or_end);
+      }
+    }
+    if (reuse)
+      fields.reset_others(target);
+    __finish_members(target);
+    --depth_;
+    return true;
+  }
+
+  template <class T>
+  std::enable_if_t<!is_sub_object<T>::value, bool> object(T&) {
+    return unplaced();
+  }
+
+  template <class T>
+  std::enable_if_t<is_sequence_container<T>::value, bool> array(T& target) {
+    if (max_depth < ++depth_)
+      return fail(structural_error::too_deep);
+    size_t count = 0u;
+    sequence_inserter<T>::start(target);
+    if (array_sizing::prescan == sizing_ && __has_reserve<T>::value)
+      __reserve_sequence(target, array_size(), mode_);
+    ++cursor_;
+    if (']' == token()) {
+      ++cursor_;
+    } else {
+      for (;;) {
+        if (!element(target, count))
+          return false;
+        char next = token();
+        ++cursor_;
+        if (',' == next)
+          continue;
+        if (']' == next)
+          break;
+        --cursor_;
+        return fail(structural_error::missing_comma_or_end);
+      }
+    }
+    __end_sequence(target, count, mode_);
+    --depth_;
+    return true;
+  }
+
+  template <class T>
+  std::enable_if_t<!is_sequence_container<T>::value, bool> array(T&) {
+    return unplaced();
+  }
+
+  // Elements of the array starting at the cursor : its commas outside of
+  // nested values, plus one when it is not empty
+  size_t array_size() const {
+    size_t nesting = 0u;
+    size_t commas = 0u;
+    for (size_t at = cursor_ + 1u; at + 1u < index_.size(); ++at) {
+      switch (data_[index_[at]]) {
+      case '{':
+      case '[':
+        ++nesting;
+        break;
+      case '}':
+      case ']':
+        if (0u == nesting)
+          return cursor_ + 1u == at ? 0u : commas + 1u;
+        --nesting;
+        break;
+      case ',':
+        if (0u == nesting)
+          ++commas;
+        break;
+      }
+    }
+    return 0u;
+  }
+
+  inline bool is_container_token() const {
+    return '{' == token() || '[' == token();
+  }
+
+  template <class... Tags>
+  bool member(named_tuple<Tags...>& tuple,
+              string_value<char, size_t> const& key,
+              __set_fields<named_tuple<Tags...>>& fields) {
+    size_t field = named_tuple_key_index<named_tuple<Tags...>>::get().index_of(
+        key.data, key.length);
+    if (sizeof...(Tags) == field) {
+      if (unknown_keys::skip == unknown_keys_)
+        return skip();
+      __ignored_value ignored;
+      return value(ignored);
+    }
+    bool converted = true;
+    if (!field_dispatch<named_tuple<Tags...>>::template apply<bool>(
+            tuple, field, [this, &converted](auto& target) -> bool {
+              return is_container_token() ? value(target)
+                                          : scalar(target, converted);
+            }))
+      return false;
+    if (converted)
+      fields.set(field);
+    return true;
+  }
+
+  template <class T>
+  std::enable_if_t<is_associative_container<T>::value &&
+                       is_sub_element<typename T::mapped_type>::value,
+                   bool>
+  child_member(T& target, string_value<char, size_t> const& key) {
+    auto inserted = associative_inserter<T>::emplace(
+        target, std::basic_string<char>(key.data, key.length),
+        typename T::mapped_type{});
+    if (!inserted)
+      return unplaced();
+    return value(*inserted);
+  }
+
+  template <class T>
+  std::enable_if_t<is_associative_container<T>::value &&
+                       !is_sub_element<typename T::mapped_type>::value,
+                   bool>
+  child_member(T&, string_value<char, size_t> const&) {
+    return unplaced();
+  }
+
+  template <class T>
+  std::enable_if_t<is_associative_container<T>::value, bool> member(
+      T& target,
+      string_value<char, size_t> const& key,
+      __set_fields<T>&) {
+    if (is_container_token())
+      return child_member(target, key);
+    typename T::mapped_type element{};
+    bool converted = false;
+    if (!scalar(element, converted))
+      return false;
+    if (converted)
+      associative_inserter<T>::emplace(
+          target, std::basic_string<char>(key.data, key.length),
+          std::move(element));
+    return true;
+  }
+
+  template <class T>
+  std::enable_if_t<is_sub_element<typename T::value_type>::value, bool>
+  child_element(T& target, size_t& count) {
+    return value(__append_element(target, count, mode_));
+  }
+
+  template <class T>
+  std::enable_if_t<!is_sub_element<typename T::value_type>::value, bool>
+  child_element(T&, size_t&) {
+    return unplaced();
+  }
+
+  template <class T> bool element(T& target, size_t& count) {
+    if (__sequence_full(target, count, mode_))
+      return fail(structural_error::too_many_elements);
+    if (is_container_token())
+      return child_element(target, count);
+    bool converted = false;
+    __append_slot<T> slot{target, count, mode_};
+    return scalar(slot, converted);
+  }
+
+ public:
+  static constexpr size_t max_depth = 1024u;
+
+  structural_parser(unknown_keys unknown = unknown_keys::fail,
+                    parse_mode mode = parse_mode::merge,
+                    array_sizing sizing = array_sizing::grow)
+      : index_()
+      , key_scratch_()
+      , value_scratch_()
+      , data_(nullptr)
+      , length_(0u)
+      , cursor_(0u)
+      , depth_(0u)
+      , unknown_keys_(unknown)
+      , mode_(mode)
+      , sizing_(sizing)
+      , result_{structural_error::none, 0u} {}
+
+  template <class Root>
+  structural_result parse(char const* data, size_t length, Root& root) {
+    static_assert(is_sub_object<Root>::value ||
+                      is_sequence_container<Root>::value,
+                  "Root type of a parser must either be a named_tuple, an "
+                  "AssociativeContainer or a SequenceContainer.");
+    structural_result indexed = index_.build(data, length);
+    if (!indexed)
+      return indexed;
+    data_ = data;
+    length_ = length;
+    cursor_ = 0u;
+    depth_ = 0u;
+    result_ = {structural_error::none, 0u};
+    if (1u == index_.size())
+      return {structural_error::empty_document, 0u};
+
+    if (is_sub_object<Root>::value ? '{' != token() : '[' != token())
+      fail(structural_error::invalid_root);
+    else if (value(root) && index_.size() - 1u != cursor_)
+      fail(structural_error::not_singular);
+    return result_;
+  }
+
+  template <class Root>
+  structural_result parse(std::string const& input, Root& root) {
+    return parse(input.data(), input.size(), root);
+  }
+};
+
+template <class Root>
+structural_result parse_json(char const* data,
+                             size_t length,
+                             Root& root,
+                             unknown_keys unknown = unknown_keys::fail,
+                             parse_mode mode = parse_mode::merge,
+                             array_sizing sizing = array_sizing::grow) {
+  structural_parser parser(unknown, mode, sizing);
+  return parser.parse(data, length, root);
+}
+
+template <class Root>
+structural_result parse_json(std::string const& input,
+                             Root& root,
+                             unknown_keys unknown = unknown_keys::fail,
+                             parse_mode mode = parse_mode::merge,
+                             array_sizing sizing = array_sizing::grow) {
+  return parse_json(input.data(), input.size(), root, unknown, mode, sizing);
+}
+
+} // namespace parsing
+} // namespace extensions
+} // namespace named_types
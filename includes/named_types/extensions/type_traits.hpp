@@ -1,13 +1,19 @@
 #pragma once
 #include <type_traits>
+#include <array>
 #include <cstdint>
 #include <vector>
+#include <deque>
 #include <list>
 #include <map>
 #include <unordered_map>
 #include <memory>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 #include "named_types/named_tuple.hpp"
 #include "named_types/rt_named_tuple.hpp"
+#include "named_types/extensions/small_vector.hpp"
 
 namespace named_types {
 
@@ -35,6 +41,17 @@ template <class CharT, class Traits, class Allocator>
 struct is_std_basic_string<std::basic_string<CharT, Traits, Allocator>>
     : std::integral_constant<bool, true> {};
 
+// is_string_view : non owning strings, to be specialized for custom views
+
+template <class T>
+struct is_string_view : std::integral_constant<bool, false> {};
+
+#if __cplusplus >= 201703L
+template <class CharT, class Traits>
+struct is_string_view<std::basic_string_view<CharT, Traits>>
+    : std::integral_constant<bool, true> {};
+#endif
+
 // is_raw_string
 
 template <class T>
@@ -48,7 +65,8 @@ template <class CharT>
 struct is_raw_string<CharT*>
     : std::integral_constant<bool, is_char<CharT>::value> {};
 
-// is_sequence_container
+// is_sequence_container : to be specialized for custom sequences, see
+// extensions::parsing::sequence_inserter
 
 template <class T>
 struct is_sequence_container : std::integral_constant<bool, false> {};
@@ -57,21 +75,36 @@ template <class T, class Allocator>
 struct is_sequence_container<std::vector<T, Allocator>>
     : std::integral_constant<bool, true> {};
 
+template <class T, class Allocator>
+struct is_sequence_container<std::deque<T, Allocator>>
+    : std::integral_constant<bool, true> {};
+
 template <class T, class Allocator>
 struct is_sequence_container<std::list<T, Allocator>>
     : std::integral_constant<bool, true> {};
 
-// is_associative_container
+// Filled by position, up to their size
+template <class T, size_t Size>
+struct is_sequence_container<std::array<T, Size>>
+    : std::integral_constant<bool, true> {};
+
+template <class T, size_t Capacity>
+struct is_sequence_container<small_vector<T, Capacity>>
+    : std::integral_constant<bool, true> {};
+
+// is_associative_container : to be specialized for custom maps, see
+// extensions::parsing::associative_inserter
 
 template <class T>
 struct is_associative_container : std::integral_constant<bool, false> {};
 
-template <class T, class Allocator>
-struct is_associative_container<std::map<T, Allocator>>
+template <class Key, class T, class Compare, class Allocator>
+struct is_associative_container<std::map<Key, T, Compare, Allocator>>
     : std::integral_constant<bool, true> {};
 
-template <class T, class Allocator>
-struct is_associative_container<std::unordered_map<T, Allocator>>
+template <class Key, class T, class Hash, class KeyEqual, class Allocator>
+struct is_associative_container<
+    std::unordered_map<Key, T, Hash, KeyEqual, Allocator>>
     : std::integral_constant<bool, true> {};
 
 // is_named_tuple
@@ -116,12 +149,24 @@ struct is_static_cast_assignable
                   value> //&& !std::is_convertible<Source,Target>::value;
       {};
 
+// Strings and string views accept character pointers, hence a null pointer
+// they can not be built from : null is never given to them
+template <class Target, class Source>
+struct is_null_into_string
+    : std::integral_constant<
+          bool,
+          std::is_same<std::nullptr_t, std::decay_t<Source>>::value &&
+              (is_std_basic_string<std::decay_t<Target>>::value ||
+               is_string_view<std::decay_t<Target>>::value)> {};
+
 template <class Source, class Tuple, size_t Index>
 struct tuple_member_assignable
     : std::integral_constant<
           bool,
           std::is_assignable<std::tuple_element_t<Index, Tuple>,
-                             Source>::value> {};
+                             Source>::value &&
+              !is_null_into_string<std::tuple_element_t<Index, Tuple>,
+                                   Source>::value> {};
 
 template <class Source, class Tuple, size_t Index>
 struct tuple_member_convertible
@@ -130,7 +175,9 @@ struct tuple_member_convertible
           std::is_convertible<Source,
                               std::tuple_element_t<Index, Tuple>>::value &&
               !std::is_assignable<std::tuple_element_t<Index, Tuple>,
-                                  Source>::value> {};
+                                  Source>::value &&
+              !is_null_into_string<std::tuple_element_t<Index, Tuple>,
+                                   Source>::value> {};
 
 template <class Source, class Tuple, size_t Index>
 struct tuple_member_static_cast_assignable
@@ -0,0 +1,241 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "named_tuple.hpp"
+#include "rt_named_tag.hpp"
+
+namespace named_types {
+
+// 64 bits FNV-1a over a (pointer, length) key, with a final avalanche step
+// since short similar names share most of their bits. Usable in constant
+// expressions.
+
+template <class CharT>
+inline constexpr uint64_t perfect_hash_key(CharT const* key, size_t length) {
+  uint64_t hash = 14695981039346656037llu;
+  for (size_t index = 0; index < length; ++index) {
+    hash ^= static_cast<unsigned char>(key[index]);
+    hash *= 1099511628211llu;
+  }
+  hash ^= hash >> 33u;
+  hash *= 0xff51afd7ed558ccdllu;
+  hash ^= hash >> 33u;
+  return hash;
+}
+
+inline constexpr uint32_t __perfect_hash_mix(uint32_t value) {
+  value ^= value >> 16;
+  value *= 0x85ebca6bu;
+  value ^= value >> 13;
+  value *= 0xc2b2ae35u;
+  value ^= value >> 16;
+  return value;
+}
+
+inline constexpr size_t __perfect_hash_table_size(size_t size) {
+  size_t result = 1u;
+  while (result < 2u * size)
+    result <<= 1u;
+  return result;
+}
+
+// Collision free hash index over a fixed set of names (hash and displace).
+// Keys are first dispatched in buckets, each bucket is given a displacement
+// placing all its keys on free slots. A lookup is one hash of the key, two
+// table reads and one final comparison against the candidate name.
+// The constructor is constexpr : with names available at compile time, the
+// whole table is built by the compiler. The search of displacements is given
+// a budget of key visits staying well within the constant evaluation limits
+// of compilers (clang stops after 2^20 steps by default) : past it, the index
+// falls back to a linear search over the names.
+template <size_t Size> class perfect_hash {
+ public:
+  static constexpr size_t size = Size;
+  static constexpr size_t table_size = __perfect_hash_table_size(Size);
+  static constexpr size_t bucket_count = Size ? Size : 1u;
+  static constexpr uint32_t max_displacement = 1u << 16u;
+  static constexpr size_t max_visits = 1u << 16u;
+
+ private:
+  char const* names_[bucket_count];
+  size_t lengths_[bucket_count];
+  uint64_t hashes_[bucket_count];
+  uint32_t displacements_[bucket_count];
+  size_t slots_[table_size];
+  bool linear_;
+
+  static constexpr size_t bucket_of(uint64_t hash) {
+    return static_cast<size_t>(hash >> 32u) % bucket_count;
+  }
+
+  static constexpr size_t slot_of(uint64_t hash, uint32_t displacement) {
+    return __perfect_hash_mix(static_cast<uint32_t>(hash) +
+                              displacement * 0x9e3779b9u) &
+           (table_size - 1u);
+  }
+
+  template <class CharT>
+  static constexpr bool equals(char const* name,
+                               CharT const* key,
+                               size_t length) {
+    for (size_t index = 0; index < length; ++index) {
+      if (name[index] != key[index])
+        return false;
+    }
+    return true;
+  }
+
+  // Keys of the bucket are the first `count` of members
+  constexpr bool place(size_t bucket,
+                       size_t const* members,
+                       size_t count,
+                       size_t& visits) {
+    for (uint32_t displacement = 0; displacement < max_displacement;
+         ++displacement) {
+      if (max_visits < (visits += 2u * count))
+        return false;
+      size_t placed = 0;
+      while (placed < count) {
+        size_t slot = slot_of(hashes_[members[placed]], displacement);
+        if (Size != slots_[slot])
+          break;
+        slots_[slot] = members[placed++];
+      }
+      if (placed == count) {
+        displacements_[bucket] = displacement;
+        return true;
+      }
+      // Rollback the keys of this bucket placed so far
+      for (size_t index = 0; index < placed; ++index)
+        slots_[slot_of(hashes_[members[index]], displacement)] = Size;
+    }
+    return false;
+  }
+
+ public:
+  constexpr perfect_hash(char const* const (&names)[bucket_count],
+                         size_t const (&lengths)[bucket_count])
+      : names_{}
+      , lengths_{}
+      , hashes_{}
+      , displacements_{}
+      , slots_{}
+      , linear_(false) {
+    size_t bucket_sizes[bucket_count]{};
+    for (size_t index = 0; index < Size; ++index) {
+      names_[index] = names[index];
+      lengths_[index] = lengths[index];
+      hashes_[index] = perfect_hash_key(names[index], lengths[index]);
+      ++bucket_sizes[bucket_of(hashes_[index])];
+    }
+    for (size_t slot = 0; slot < table_size; ++slot)
+      slots_[slot] = Size;
+
+    // Largest buckets are placed first
+    size_t members[bucket_count]{};
+    size_t visits = 0;
+    for (size_t bucket_size = Size; 0u < bucket_size && !linear_;
+         --bucket_size) {
+      for (size_t bucket = 0; bucket < bucket_count && !linear_; ++bucket) {
+        if (bucket_size != bucket_sizes[bucket])
+          continue;
+        size_t count = 0;
+        for (size_t index = 0; index < Size; ++index) {
+          if (bucket_of(hashes_[index]) == bucket)
+            members[count++] = index;
+        }
+        visits += Size;
+        if (!place(bucket, members, count, visits))
+          linear_ = true;
+      }
+    }
+  }
+
+  // False when the index fell back to a linear search
+  inline constexpr bool hashed() const { return !linear_; }
+
+  // Returns size if the key is not one of the names
+  template <class CharT>
+  inline constexpr size_t index_of(CharT const* key, size_t length) const {
+    if (linear_) {
+      for (size_t index = 0; index < Size; ++index) {
+        if (length == lengths_[index] && equals(names_[index], key, length))
+          return index;
+      }
+      return Size;
+    }
+    uint64_t hash = perfect_hash_key(key, length);
+    size_t index = slots_[slot_of(hash, displacements_[bucket_of(hash)])];
+    return (Size != index && length == lengths_[index] &&
+                    equals(names_[index], key, length)
+                ? index
+                : Size);
+  }
+
+  inline constexpr char const* name_at(size_t index) const {
+    return index < Size ? names_[index] : nullptr;
+  }
+};
+
+// Names usable in constant expressions, only string literals provide them
+
+template <class T> struct constexpr_name {
+  static constexpr bool const value = false;
+};
+
+template <class T, T... chars> struct constexpr_name<string_literal<T, chars...>> {
+  static constexpr bool const value = true;
+  static constexpr char const data[sizeof...(chars)+1u] = {chars..., '\0'};
+  static constexpr size_t const size = sizeof...(chars);
+};
+
+template <class T, T... chars>
+constexpr char const
+    constexpr_name<string_literal<T, chars...>>::data[sizeof...(chars)+1u];
+
+// Per named_tuple perfect hash index of its attribute names
+
+template <class Tuple> struct named_tuple_key_index;
+
+template <bool IsConstexpr, class... Types> struct __named_tuple_key_index;
+
+template <class... Types> struct __named_tuple_key_index<true, Types...> {
+  using index_type = perfect_hash<sizeof...(Types)>;
+  static constexpr index_type const value{
+      {constexpr_name<
+          typename __ntuple_tag_spec_t<Types>::value_type>::data...},
+      {constexpr_name<
+          typename __ntuple_tag_spec_t<Types>::value_type>::size...}};
+  static inline index_type const& get() { return value; }
+};
+
+template <class... Types>
+constexpr typename __named_tuple_key_index<true, Types...>::index_type const
+    __named_tuple_key_index<true, Types...>::value;
+
+template <class... Types> struct __named_tuple_key_index<false, Types...> {
+  using index_type = perfect_hash<sizeof...(Types)>;
+  static inline index_type const& get() {
+    static index_type const value{
+        {type_name<typename __ntuple_tag_spec_t<Types>::value_type>::value...},
+        {std::strlen(type_name<
+                     typename __ntuple_tag_spec_t<Types>::value_type>::value)...}};
+    return value;
+  }
+};
+
+template <bool... Values>
+struct __perfect_hash_all_of
+    : std::is_same<std::integer_sequence<bool, true, Values...>,
+                   std::integer_sequence<bool, Values..., true>> {};
+
+template <class... Types>
+struct named_tuple_key_index<named_tuple<Types...>>
+    : __named_tuple_key_index<
+          __perfect_hash_all_of<constexpr_name<
+              typename __ntuple_tag_spec_t<Types>::value_type>::value...>::
+              value,
+          Types...> {};
+
+} // namespace named_types
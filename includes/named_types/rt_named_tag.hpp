@@ -1,5 +1,13 @@
 #pragma once
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
 #include <typeinfo>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 #include "named_tag.hpp"
 
 namespace named_types {
@@ -42,23 +50,109 @@ char const* type_name<string_literal<T, chars...>>::value =
     string_literal<T, chars...>::data;
 //#endif  // _MSC_VER
 
+// Identifier of a type for the runtime checks : hash of its name as spelled
+// by the compiler, computed at compile time. Compared as one integer, and the
+// same in every shared object, unlike the addresses of type_info objects.
+// Ids are only stable across code built by the same compiler. Being hashes
+// they could collide : the tuples viewed at runtime check at compile time
+// that their distinct tags, and their distinct field types, have distinct
+// ids.
+struct rt_type_id {
+  uint64_t hash;
+
+  inline constexpr bool operator==(rt_type_id other) const {
+    return hash == other.hash;
+  }
+  inline constexpr bool operator!=(rt_type_id other) const {
+    return hash != other.hash;
+  }
+};
+
+inline constexpr uint64_t __rt_type_hash(char const* signature) {
+  uint64_t hash = 14695981039346656037llu;
+  for (; *signature; ++signature) {
+    hash ^= static_cast<unsigned char>(*signature);
+    hash *= 1099511628211llu;
+  }
+  return hash;
+}
+
+// The signature of this function names T
+template <class T> inline constexpr uint64_t __rt_type_hash() {
+#if defined(_MSC_VER)
+  return __rt_type_hash(__FUNCSIG__);
+#else
+  return __rt_type_hash(__PRETTY_FUNCTION__);
+#endif
+}
+
+template <class T> struct __rt_type_id {
+  static constexpr rt_type_id value = {__rt_type_hash<T>()};
+};
+template <class T> constexpr rt_type_id __rt_type_id<T>::value;
+
+// Cv-qualifiers are ignored, as by typeid
+template <class T> inline constexpr rt_type_id rt_type_id_of() {
+  return __rt_type_id<std::remove_cv_t<T>>::value;
+}
+
+// Whether T has an id distinct from the ids of the other types
+template <class T, class... Types> inline constexpr bool __rt_id_distinct() {
+  bool distinct = true;
+  for (bool each : {true,
+                    (std::is_same<std::remove_cv_t<T>,
+                                  std::remove_cv_t<Types>>::value ||
+                     rt_type_id_of<T>() != rt_type_id_of<Types>())...})
+    distinct = distinct && each;
+  return distinct;
+}
+
+template <class... Types> inline constexpr bool __rt_ids_distinct() {
+  bool distinct = true;
+  for (bool each : {true, __rt_id_distinct<Types, Types...>()...})
+    distinct = distinct && each;
+  return distinct;
+}
+
+// Attribute name given to the runtime lookups, without copying it
+struct rt_name {
+  char const* data;
+  size_t length;
+
+  rt_name(char const* name, size_t name_length)
+      : data(name)
+      , length(name_length) {}
+  rt_name(char const* name)
+      : data(name)
+      , length(std::strlen(name)) {}
+  rt_name(std::string const& name)
+      : data(name.data())
+      , length(name.size()) {}
+#if __cplusplus >= 201703L
+  rt_name(std::string_view name)
+      : data(name.data())
+      , length(name.size()) {}
+#endif
+};
+
 // Default base class for runtime views
 struct base_const_rt_view {
   virtual size_t index_of(std::type_info const& tag_id) const = 0;
-  virtual size_t index_of(std::string const& name) const = 0;
+  virtual size_t index_of(rt_type_id tag_id) const = 0;
+  virtual size_t index_of(rt_name name) const = 0;
   virtual std::type_info const& typeid_at(size_t index) const = 0;
-  virtual std::type_info const& typeid_at(std::string const& name) const = 0;
+  virtual std::type_info const& typeid_at(rt_name name) const = 0;
+  virtual rt_type_id type_id_at(size_t index) const = 0;
   virtual void const* retrieve_raw(size_t index) const = 0;
-  virtual void const* retrieve_raw(std::string const& name) const = 0;
+  virtual void const* retrieve_raw(rt_name name) const = 0;
 
   template <typename T> inline T const* retrieve(size_t index) const {
-    return (typeid(T) == typeid_at(index)
+    return (rt_type_id_of<T>() == type_id_at(index)
                 ? reinterpret_cast<T const*>(retrieve_raw(index))
                 : nullptr);
   }
 
-  template <typename T>
-  inline T const* retrieve(std::string const& name) const {
+  template <typename T> inline T const* retrieve(rt_name name) const {
     size_t index = index_of(name);
     return retrieve<T>(index);
   }
@@ -67,15 +161,15 @@ template <class Parent, class Tagged> struct const_rt_view_impl;
 
 struct base_rt_view : public base_const_rt_view {
   virtual void* retrieve_raw(size_t index) = 0;
-  virtual void* retrieve_raw(std::string const& name) = 0;
+  virtual void* retrieve_raw(rt_name name) = 0;
 
   template <typename T> inline T* retrieve(size_t index) {
-    return (typeid(T) == typeid_at(index)
-                ? reinterpret_cast<T const*>(retrieve_raw(index))
+    return (rt_type_id_of<T>() == type_id_at(index)
+                ? reinterpret_cast<T*>(retrieve_raw(index))
                 : nullptr);
   }
 
-  template <typename T> inline T* retrieve(std::string const& name) {
+  template <typename T> inline T* retrieve(rt_name name) {
     size_t index = index_of(name);
     return retrieve<T>(index);
   }
@@ -1,19 +1,33 @@
 #pragma once
 #include "named_tuple.hpp"
 #include "rt_named_tag.hpp"
+#include "perfect_hash.hpp"
 #include <array>
 #include <algorithm>
+#include <string>
+#include <type_traits>
+#include <utility>
 
 namespace named_types {
 
+template <bool Mutable, class... Types> struct __rt_visited_view;
+
 template <class Parent, class... Types>
 struct const_rt_view_impl<Parent, named_tuple<Types...>> : public Parent {
+  template <bool Mutable, class... Visited> friend struct __rt_visited_view;
+  static_assert(
+      __rt_ids_distinct<typename __ntuple_tag_spec_t<Types>::type...>() &&
+          __rt_ids_distinct<__ntuple_tag_elem_t<Types>...>(),
+      "Type ids of the tags or fields of a tuple collide.");
+
  protected:
   using value_type = named_tuple<Types...> const;
   static const std::array<std::type_info const*, sizeof...(Types)>
       tag_typeinfos;
   static const std::array<std::type_info const*, sizeof...(Types)>
       value_typeinfos;
+  static const std::array<rt_type_id, sizeof...(Types)> tag_type_ids;
+  static const std::array<rt_type_id, sizeof...(Types)> value_type_ids;
   static const std::array<std::string const, sizeof...(Types)> attributes;
   static const size_t size = sizeof...(Types);
 
@@ -26,46 +40,44 @@ struct const_rt_view_impl<Parent, named_tuple<Types...>> : public Parent {
             &std::get<__ntuple_tag_spec_t<Types>>(viewed))...} {}
 
   virtual size_t index_of(std::type_info const& tag_id) const {
-    auto matching_attribute_iterator =
-        std::find(begin(tag_typeinfos), end(tag_typeinfos), &tag_id);
+    auto matching_attribute_iterator = std::find_if(
+        begin(tag_typeinfos), end(tag_typeinfos),
+        [&](std::type_info const* info) { return *info == tag_id; });
     return (
         end(tag_typeinfos) != matching_attribute_iterator
             ? std::distance(begin(tag_typeinfos), matching_attribute_iterator)
             : size);
   }
 
-  virtual size_t index_of(std::string const& name) const {
-    auto matching_attribute_iterator =
-        std::find(begin(attributes), end(attributes), name);
-    return (end(attributes) != matching_attribute_iterator
-                ? std::distance(begin(attributes), matching_attribute_iterator)
-                : size);
+  virtual size_t index_of(rt_type_id tag_id) const {
+    return static_cast<size_t>(
+        std::find(begin(tag_type_ids), end(tag_type_ids), tag_id) -
+        begin(tag_type_ids));
+  }
+
+  virtual size_t index_of(rt_name name) const {
+    return named_tuple_key_index<named_tuple<Types...>>::get().index_of(
+        name.data, name.length);
   }
 
   virtual std::type_info const& typeid_at(size_t index) const {
     return (index < size ? *value_typeinfos[index] : typeid(void));
   }
 
-  virtual std::type_info const& typeid_at(std::string const& name) const {
-    auto matching_attribute_iterator =
-        std::find(begin(attributes), end(attributes), name);
-    return (end(attributes) != matching_attribute_iterator
-                ? *value_typeinfos[std::distance(begin(attributes),
-                                                 matching_attribute_iterator)]
-                : typeid(void));
+  virtual std::type_info const& typeid_at(rt_name name) const {
+    return const_rt_view_impl::typeid_at(const_rt_view_impl::index_of(name));
+  }
+
+  virtual rt_type_id type_id_at(size_t index) const {
+    return (index < size ? value_type_ids[index] : rt_type_id_of<void>());
   }
 
   virtual void const* retrieve_raw(size_t index) const {
     return (index < size ? pointers_[index] : nullptr);
   }
 
-  virtual void const* retrieve_raw(std::string const& name) const {
-    auto matching_attribute_iterator =
-        std::find(begin(attributes), end(attributes), name);
-    return (end(attributes) != matching_attribute_iterator
-                ? pointers_[std::distance(begin(attributes),
-                                          matching_attribute_iterator)]
-                : nullptr);
+  virtual void const* retrieve_raw(rt_name name) const {
+    return const_rt_view_impl::retrieve_raw(const_rt_view_impl::index_of(name));
   }
 };
 
@@ -79,6 +91,16 @@ std::array<std::type_info const*, sizeof...(Types)> const
     const_rt_view_impl<Parent, named_tuple<Types...>>::value_typeinfos = {
         {&typeid(__ntuple_tag_elem_t<Types>)...}};
 
+template <class Parent, class... Types>
+std::array<rt_type_id, sizeof...(Types)> const
+    const_rt_view_impl<Parent, named_tuple<Types...>>::tag_type_ids = {
+        {rt_type_id_of<typename __ntuple_tag_spec_t<Types>::type>()...}};
+
+template <class Parent, class... Types>
+std::array<rt_type_id, sizeof...(Types)> const
+    const_rt_view_impl<Parent, named_tuple<Types...>>::value_type_ids = {
+        {rt_type_id_of<__ntuple_tag_elem_t<Types>>()...}};
+
 template <class Parent, class... Types>
 std::array<std::string const, sizeof...(Types)> const
     const_rt_view_impl<Parent, named_tuple<Types...>>::attributes = {
@@ -102,16 +124,446 @@ struct rt_view_impl<base_rt_view, named_tuple<Types...>>
                 : nullptr);
   }
 
-  virtual void* retrieve_raw(std::string const& name) {
-    auto matching_attribute_iterator =
-        std::find(begin(const_rt_view_type::attributes),
-                  end(const_rt_view_type::attributes), name);
-    return (end(const_rt_view_type::attributes) != matching_attribute_iterator
-                ? const_rt_view_type::pointers_[std::distance(
-                      begin(const_rt_view_type::attributes),
-                      matching_attribute_iterator)]
+  virtual void* retrieve_raw(rt_name name) {
+    return rt_view_impl::retrieve_raw(const_rt_view_type::index_of(name));
+  }
+};
+
+// Fields of a tuple type for the runtime references, described once per type
+// : each field lies at a fixed offset from the start of its tuple, and names
+// are found by the perfect hash of the tuple type.
+struct rt_descriptor {
+  size_t size;
+  std::type_info const* const* tag_typeinfos;
+  std::type_info const* const* value_typeinfos;
+  rt_type_id const* tag_type_ids;
+  rt_type_id const* value_type_ids;
+  std::string const* attributes;
+  size_t const* offsets;
+  size_t (*find_name)(char const* name, size_t length);
+
+  size_t index_of(std::type_info const& tag_id) const {
+    // Compared by value, since type_info objects may be duplicated across
+    // shared objects
+    return static_cast<size_t>(
+        std::find_if(
+            tag_typeinfos, tag_typeinfos + size,
+            [&](std::type_info const* info) { return *info == tag_id; }) -
+        tag_typeinfos);
+  }
+
+  inline size_t index_of(rt_type_id tag_id) const {
+    return static_cast<size_t>(
+        std::find(tag_type_ids, tag_type_ids + size, tag_id) - tag_type_ids);
+  }
+
+  inline size_t index_of(rt_name name) const {
+    return find_name(name.data, name.length);
+  }
+
+  std::type_info const& typeid_at(size_t index) const {
+    return (index < size ? *value_typeinfos[index] : typeid(void));
+  }
+
+  inline rt_type_id type_id_at(size_t index) const {
+    return (index < size ? value_type_ids[index] : rt_type_id_of<void>());
+  }
+
+  inline void* field(void* object, size_t index) const {
+    return (index < size ? static_cast<char*>(object) + offsets[index]
+                         : nullptr);
+  }
+};
+
+template <class Tuple> class __rt_layout;
+
+template <class... Types> class __rt_layout<named_tuple<Types...>> {
+  static_assert(
+      std::is_same<std::integer_sequence<bool,
+                                         false,
+                                         std::is_reference<
+                                             __ntuple_tag_elem_t<Types>>::
+                                             value...>,
+                   std::integer_sequence<bool,
+                                         std::is_reference<
+                                             __ntuple_tag_elem_t<Types>>::
+                                             value...,
+                                         false>>::value,
+      "Fields of tuples viewed by offsets must not be references.");
+  static_assert(
+      __rt_ids_distinct<typename __ntuple_tag_spec_t<Types>::type...>() &&
+          __rt_ids_distinct<__ntuple_tag_elem_t<Types>...>(),
+      "Type ids of the tags or fields of a tuple collide.");
+
+  static std::array<std::type_info const*, sizeof...(Types)> const
+      tag_typeinfos;
+  static std::array<std::type_info const*, sizeof...(Types)> const
+      value_typeinfos;
+  static std::array<rt_type_id, sizeof...(Types)> const tag_type_ids;
+  static std::array<rt_type_id, sizeof...(Types)> const value_type_ids;
+  static std::array<std::string const, sizeof...(Types)> const attributes;
+  static std::array<size_t, sizeof...(Types)> const offsets;
+
+  static size_t find_name(char const* name, size_t length) {
+    return named_tuple_key_index<named_tuple<Types...>>::get().index_of(
+        name, length);
+  }
+
+  template <class T>
+  static inline size_t offset(named_tuple<Types...> const& sample,
+                              T const& field) {
+    return static_cast<size_t>(reinterpret_cast<char const*>(&field) -
+                               reinterpret_cast<char const*>(&sample));
+  }
+
+  // Offsets taken in storage for a tuple, as offsetof does, without
+  // constructing one
+  static std::array<size_t, sizeof...(Types)> measure() {
+    using tuple_type = named_tuple<Types...>;
+    std::aligned_storage_t<sizeof(tuple_type), alignof(tuple_type)> storage;
+    tuple_type const& sample = reinterpret_cast<tuple_type const&>(storage);
+    return {{offset(sample, std::get<__ntuple_tag_spec_t<Types>>(sample))...}};
+  }
+
+ public:
+  // Shared by all the objects of the type, reached without a guard. Offsets
+  // are measured during the static initialization.
+  static rt_descriptor const descriptor;
+};
+
+template <class... Types>
+std::array<std::type_info const*, sizeof...(Types)> const
+    __rt_layout<named_tuple<Types...>>::tag_typeinfos = {
+        {&typeid(typename __ntuple_tag_spec_t<Types>::type)...}};
+
+template <class... Types>
+std::array<std::type_info const*, sizeof...(Types)> const
+    __rt_layout<named_tuple<Types...>>::value_typeinfos = {
+        {&typeid(__ntuple_tag_elem_t<Types>)...}};
+
+template <class... Types>
+std::array<rt_type_id, sizeof...(Types)> const
+    __rt_layout<named_tuple<Types...>>::tag_type_ids = {
+        {rt_type_id_of<typename __ntuple_tag_spec_t<Types>::type>()...}};
+
+template <class... Types>
+std::array<rt_type_id, sizeof...(Types)> const
+    __rt_layout<named_tuple<Types...>>::value_type_ids = {
+        {rt_type_id_of<__ntuple_tag_elem_t<Types>>()...}};
+
+template <class... Types>
+std::array<std::string const, sizeof...(Types)> const
+    __rt_layout<named_tuple<Types...>>::attributes = {
+        {std::string(type_name<
+            typename __ntuple_tag_spec_t<Types>::value_type>::value)...}};
+
+template <class... Types>
+std::array<size_t, sizeof...(Types)> const
+    __rt_layout<named_tuple<Types...>>::offsets =
+        __rt_layout<named_tuple<Types...>>::measure();
+
+template <class... Types>
+rt_descriptor const __rt_layout<named_tuple<Types...>>::descriptor = {
+    sizeof...(Types),      tag_typeinfos.data(), value_typeinfos.data(),
+    tag_type_ids.data(),   value_type_ids.data(), attributes.data(),
+    offsets.data(),        &find_name};
+
+template <class... Types>
+inline rt_descriptor const& rt_descriptor_of(named_tuple<Types...> const&) {
+  return __rt_layout<named_tuple<Types...>>::descriptor;
+}
+
+inline size_t __rt_find_no_name(char const*, size_t) { return 0u; }
+
+// Descriptor of no field, for the default constructed references
+inline rt_descriptor const& __rt_empty_descriptor() {
+  static rt_descriptor const descriptor{0u,      nullptr, nullptr,
+                                        nullptr, nullptr, nullptr,
+                                        nullptr, &__rt_find_no_name};
+  return descriptor;
+}
+
+template <class T> class rt_field;
+
+// Runtime view without virtual functions, copied by value : the address of
+// the viewed tuple and the descriptor of its type. Building one from a
+// descriptor already at hand costs two stores.
+class const_rt_ref {
+  template <class T> friend class rt_field;
+
+ protected:
+  // Not const to profit to the non const version inheriting from it
+  void* object_;
+  rt_descriptor const* descriptor_;
+
+ public:
+  const_rt_ref(void const* object, rt_descriptor const& descriptor)
+      : object_(const_cast<void*>(object))
+      , descriptor_(&descriptor) {}
+
+  const_rt_ref()
+      : const_rt_ref(nullptr, __rt_empty_descriptor()) {}
+
+  template <class... Types>
+  const_rt_ref(named_tuple<Types...> const& viewed)
+      : const_rt_ref(&viewed, rt_descriptor_of(viewed)) {}
+
+  inline rt_descriptor const& descriptor() const { return *descriptor_; }
+  inline size_t size() const { return descriptor_->size; }
+
+  inline size_t index_of(std::type_info const& tag_id) const {
+    return descriptor_->index_of(tag_id);
+  }
+
+  inline size_t index_of(rt_type_id tag_id) const {
+    return descriptor_->index_of(tag_id);
+  }
+
+  inline size_t index_of(rt_name name) const {
+    return descriptor_->index_of(name);
+  }
+
+  inline std::type_info const& typeid_at(size_t index) const {
+    return descriptor_->typeid_at(index);
+  }
+
+  inline std::type_info const& typeid_at(rt_name name) const {
+    return descriptor_->typeid_at(index_of(name));
+  }
+
+  inline rt_type_id type_id_at(size_t index) const {
+    return descriptor_->type_id_at(index);
+  }
+
+  inline void const* retrieve_raw(size_t index) const {
+    return descriptor_->field(object_, index);
+  }
+
+  inline void const* retrieve_raw(rt_name name) const {
+    return descriptor_->field(object_, index_of(name));
+  }
+
+  template <typename T> inline T const* retrieve(size_t index) const {
+    return (rt_type_id_of<T>() == type_id_at(index)
+                ? static_cast<T const*>(retrieve_raw(index))
+                : nullptr);
+  }
+
+  template <typename T> inline T const* retrieve(rt_name name) const {
+    return retrieve<T>(index_of(name));
+  }
+
+  // Handles to reach the field again, in any tuple of the same type
+  template <typename T> inline rt_field<T> field(size_t index) const {
+    return rt_field<T>(*descriptor_, index);
+  }
+
+  template <typename T> inline rt_field<T> field(rt_name name) const {
+    return rt_field<T>(*descriptor_, index_of(name));
+  }
+};
+
+class rt_ref : public const_rt_ref {
+ public:
+  rt_ref(void* object, rt_descriptor const& descriptor)
+      : const_rt_ref(object, descriptor) {}
+
+  rt_ref() = default;
+
+  template <class... Types>
+  rt_ref(named_tuple<Types...>& viewed)
+      : const_rt_ref(viewed) {}
+
+  using const_rt_ref::retrieve_raw;
+  using const_rt_ref::retrieve;
+
+  inline void* retrieve_raw(size_t index) {
+    return descriptor_->field(object_, index);
+  }
+
+  inline void* retrieve_raw(rt_name name) {
+    return descriptor_->field(object_, index_of(name));
+  }
+
+  template <typename T> inline T* retrieve(size_t index) {
+    return (rt_type_id_of<T>() == type_id_at(index)
+                ? static_cast<T*>(retrieve_raw(index))
                 : nullptr);
   }
+
+  template <typename T> inline T* retrieve(rt_name name) {
+    return retrieve<T>(index_of(name));
+  }
 };
 
+// Field of type T found once by index or by name, then reached in the
+// references to tuples of the same type from its offset, without searching
+// again. Handles to missing fields or fields of other types are empty.
+template <class T> class rt_field {
+  rt_descriptor const* descriptor_;
+  size_t offset_;
+
+ public:
+  rt_field()
+      : descriptor_(nullptr)
+      , offset_(0u) {}
+
+  rt_field(rt_descriptor const& descriptor, size_t index)
+      : descriptor_(rt_type_id_of<T>() == descriptor.type_id_at(index)
+                        ? &descriptor
+                        : nullptr)
+      , offset_(descriptor_ ? descriptor.offsets[index] : 0u) {}
+
+  inline explicit operator bool() const { return nullptr != descriptor_; }
+
+  // Null when the handle is empty or the reference is to another type
+  inline T const* in(const_rt_ref const& ref) const {
+    return (descriptor_ == ref.descriptor_
+                ? reinterpret_cast<T const*>(
+                      static_cast<char const*>(ref.object_) + offset_)
+                : nullptr);
+  }
+
+  inline T* in(rt_ref const& ref) const {
+    return (descriptor_ == ref.descriptor_
+                ? reinterpret_cast<T*>(static_cast<char*>(ref.object_) +
+                                       offset_)
+                : nullptr);
+  }
+};
+
+template <class... Types>
+inline const_rt_ref make_rt_ref(named_tuple<Types...> const& viewed) {
+  return const_rt_ref(viewed);
+}
+
+template <class... Types>
+inline rt_ref make_rt_ref(named_tuple<Types...>& viewed) {
+  return rt_ref(viewed);
+}
+
+// Type erased views held by value, for storing views of tuples of different
+// types side by side : no allocation, no virtual call, copied as two
+// pointers. Default constructed ones view no field.
+using any_const_rt_view = const_rt_ref;
+using any_rt_view = rt_ref;
+
+static_assert(std::is_trivially_copyable<any_rt_view>::value &&
+                  sizeof(any_rt_view) == 2u * sizeof(void*),
+              "Type erased views must stay two copyable pointers.");
+
+// Tuples and views of a tuple type known at compile time can be visited :
+// their fields, typed, are reached from a runtime index.
+
+template <size_t Index, class... Types>
+using __rt_field_spec_t = std::tuple_element_t<Index, std::tuple<Types...>>;
+
+template <class... Types> struct __rt_visited_fields : std::true_type {
+  using tuple_type = named_tuple<Types...>;
+  template <size_t Index>
+  using tag_type = __ntuple_tag_spec_t<__rt_field_spec_t<Index, Types...>>;
+  template <size_t Index>
+  using value_type = __ntuple_tag_elem_t<__rt_field_spec_t<Index, Types...>>;
+};
+
+template <class Object> struct __rt_visited : std::false_type {};
+
+template <class... Types>
+struct __rt_visited<named_tuple<Types...>> : __rt_visited_fields<Types...> {
+  template <size_t Index>
+  static inline decltype(auto) field(named_tuple<Types...>& object) {
+    return std::get<Index>(object);
+  }
+};
+
+template <class... Types>
+struct __rt_visited<named_tuple<Types...> const>
+    : __rt_visited_fields<Types...> {
+  template <size_t Index>
+  static inline decltype(auto) field(named_tuple<Types...> const& object) {
+    return std::get<Index>(object);
+  }
+};
+
+// Views of non-const tuples give mutable fields, other views const ones
+template <bool Mutable, class... Types>
+struct __rt_visited_view : __rt_visited_fields<Types...> {
+  using fields = __rt_visited_fields<Types...>;
+  template <size_t Index>
+  using field_type =
+      std::conditional_t<Mutable,
+                         typename fields::template value_type<Index>,
+                         typename fields::template value_type<Index> const>;
+
+  template <size_t Index, class View>
+  static inline field_type<Index>& field(View& view) {
+    return *static_cast<field_type<Index>*>(view.pointers_[Index]);
+  }
+};
+
+template <class Parent, class... Types>
+struct __rt_visited<const_rt_view_impl<Parent, named_tuple<Types...>>>
+    : __rt_visited_view<false, Types...> {};
+
+template <class Parent, class... Types>
+struct __rt_visited<const_rt_view_impl<Parent, named_tuple<Types...>> const>
+    : __rt_visited_view<false, Types...> {};
+
+template <class... Types>
+struct __rt_visited<rt_view_impl<base_rt_view, named_tuple<Types...>>>
+    : __rt_visited_view<true, Types...> {};
+
+template <class... Types>
+struct __rt_visited<rt_view_impl<base_rt_view, named_tuple<Types...>> const>
+    : __rt_visited_view<false, Types...> {};
+
+template <size_t Index, class Object, class Func>
+void __rt_visit_field(Object& object, Func& f) {
+  using visited = __rt_visited<Object>;
+  f(typename visited::template tag_type<Index>{},
+    visited::template field<Index>(object));
+}
+
+template <class Object, class Func, size_t... Indices>
+inline bool __rt_visit(Object& object,
+                       size_t index,
+                       Func& f,
+                       std::index_sequence<Indices...>) {
+  // One function per field, the last entry keeping the table non empty
+  using field_visitor = void (*)(Object&, Func&);
+  static constexpr field_visitor visitors[] = {
+      &__rt_visit_field<Indices, Object, Func>..., nullptr};
+  if (sizeof...(Indices) <= index)
+    return false;
+  visitors[index](object, f);
+  return true;
+}
+
+// f is called as by for_each with the tag and the value of the field at
+// index, or of the name given. Returns false, without calling it, when there
+// is no such field.
+
+template <class Object,
+          class Func,
+          class Visited = __rt_visited<std::remove_reference_t<Object>>>
+inline std::enable_if_t<Visited::value, bool> visit(Object&& object,
+                                                    size_t index,
+                                                    Func&& f) {
+  return __rt_visit(
+      object, index, f,
+      std::make_index_sequence<Visited::tuple_type::size>());
+}
+
+template <class Object,
+          class Func,
+          class Visited = __rt_visited<std::remove_reference_t<Object>>>
+inline std::enable_if_t<Visited::value, bool> visit(Object&& object,
+                                                    rt_name name,
+                                                    Func&& f) {
+  return visit(std::forward<Object>(object),
+               named_tuple_key_index<typename Visited::tuple_type>::get()
+                   .index_of(name.data, name.length),
+               std::forward<Func>(f));
+}
+
 } // namespace named_types
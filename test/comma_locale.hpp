@@ -0,0 +1,24 @@
+#pragma once
+#include <clocale>
+#include <string>
+
+// Sets LC_NUMERIC to a locale with a ',' decimal point while in scope, when
+// one is installed
+struct comma_locale {
+  std::string previous;
+  bool active;
+  comma_locale()
+      : previous(std::setlocale(LC_NUMERIC, nullptr))
+      , active(false) {
+    for (char const* name : {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8",
+                             "fr_FR.utf8", "de_DE", "fr_FR", "German"}) {
+      if (std::setlocale(LC_NUMERIC, name) &&
+          ',' == *std::localeconv()->decimal_point) {
+        active = true;
+        return;
+      }
+    }
+    std::setlocale(LC_NUMERIC, previous.c_str());
+  }
+  ~comma_locale() { std::setlocale(LC_NUMERIC, previous.c_str()); }
+};
@@ -11,7 +11,9 @@
 #include <named_types/rt_named_tuple.hpp>
 #include <named_types/extensions/factory.hpp>
 #include <named_types/extensions/parsing_tools.hpp>
+#include <named_types/extensions/json_writer.hpp>
 #include "catch.hpp"
+#include "comma_locale.hpp"
 
 namespace {
 size_t constexpr operator"" _s(const char* c, size_t s) {
@@ -107,3 +109,144 @@ TEST_CASE("ParsersTools1", "[ParsersTools1]") {
   CHECK(23 == (lexical_cast<int>(std::string("23"))));
   CHECK(23 == (lexical_cast<int>("23")));
 }
+
+TEST_CASE("LexicalCast1", "[LexicalCast1]") {
+  using namespace named_types::extensions::parsing;
+
+  // Numbers read back to the same value
+  CHECK("-2147483648" == lexical_cast<std::string>(int32_t(-2147483647 - 1)));
+  CHECK("18446744073709551615" == lexical_cast<std::string>(UINT64_MAX));
+  CHECK("0.1" == lexical_cast<std::string>(0.1));
+  CHECK("1.5" == lexical_cast<std::string>(1.5f));
+  CHECK(0.1 == lexical_cast<double>(lexical_cast<std::string>(0.1)));
+  CHECK(1. / 3. == lexical_cast<double>(lexical_cast<std::string>(1. / 3.)));
+  CHECK(-12 == lexical_cast<int8_t>(std::string("-12")));
+  CHECK("200" == lexical_cast<std::string>(uint8_t(200)));
+  CHECK(INT64_MIN == lexical_cast<int64_t>("-9223372036854775808"));
+  CHECK(1e10f == lexical_cast<float>("1e10"));
+  CHECK(-2.5 == lexical_cast<long double>(std::string("-2.5")));
+
+  // Failures leave the target untouched
+  int value = 7;
+  CHECK_FALSE(try_lexical_cast(value, ""));
+  CHECK_FALSE(try_lexical_cast(value, "12a"));
+  CHECK_FALSE(try_lexical_cast(value, " 12"));
+  CHECK_FALSE(try_lexical_cast(value, "2147483648"));
+  CHECK_FALSE(try_lexical_cast(value, std::string("1.5")));
+  unsigned short small = 7u;
+  CHECK_FALSE(try_lexical_cast(small, "65536"));
+  CHECK_FALSE(try_lexical_cast(small, "-1"));
+  CHECK(7 == value);
+  CHECK(7u == small);
+  double number = 7.;
+  CHECK_FALSE(try_lexical_cast(number, "1e400"));
+  CHECK_FALSE(try_lexical_cast(number, "1.5 "));
+  CHECK_FALSE(try_lexical_cast(number, "-"));
+  CHECK(7. == number);
+  CHECK_THROWS_AS(lexical_cast<int>("x"), bad_lexical_cast const&);
+
+  // Streams for the other types
+  CHECK("a" == lexical_cast<std::string>('a'));
+  CHECK(L"12" == lexical_cast<std::wstring>(12));
+  CHECK(12 == lexical_cast<int>(std::wstring(L"12")));
+  CHECK_FALSE(try_lexical_cast(value, std::wstring(L"12 ")));
+  CHECK(lexical_cast<bool>("1"));
+  CHECK_THROWS_AS(lexical_cast<bool>("true"), bad_lexical_cast const&);
+}
+
+TEST_CASE("LexicalCast2", "[LexicalCast2]") {
+  using namespace named_types::extensions::parsing;
+
+  // Numbers keep a '.' whatever the locale
+  comma_locale locale;
+  if (!locale.active) {
+    WARN("No locale with a ',' decimal point is installed");
+    return;
+  }
+  CHECK("1.5" == lexical_cast<std::string>(1.5));
+  CHECK("0.1" == lexical_cast<std::string>(0.1f));
+  CHECK(1. / 3. == lexical_cast<double>(lexical_cast<std::string>(1. / 3.)));
+  CHECK(-2.5 == lexical_cast<double>("-2.5"));
+  CHECK(1.25e-7L == lexical_cast<long double>("1.25e-7"));
+  double number = 7.;
+  CHECK_FALSE(try_lexical_cast(number, "1,5"));
+  CHECK(7. == number);
+}
+
+TEST_CASE("FrameArena1", "[FrameArena1]") {
+  using namespace named_types::extensions::parsing;
+
+  frame_arena arena;
+  auto start = arena.position();
+  void* first = arena.allocate(24u);
+  void* second = arena.allocate(8000u);
+  CHECK(first != second);
+  CHECK(0u == reinterpret_cast<uintptr_t>(second) % alignof(std::max_align_t));
+
+  // Released memory is given back in the same order
+  arena.release(start);
+  CHECK(first == arena.allocate(24u));
+  CHECK(second == arena.allocate(8000u));
+}
+
+TEST_CASE("JsonWriter1", "[JsonWriter1]") {
+  using namespace named_types;
+  using namespace named_types::extensions::generation;
+
+  using quoted = named_tag<string_literal<char, 'a', '"', 'b'>>;
+  using Child = named_tuple<std::string(name), int(age)>;
+  using Root = named_tuple<std::string(name),
+                           int(age),
+                           double(size),
+                           bool(child1),
+                           std::vector<Child>(children),
+                           std::map<std::string, int64_t>(miles),
+                           std::unique_ptr<int>(list),
+                           uint64_t(quoted)>;
+  CHECK((std::is_same<string_literal<char, ',', '"', 'a', 'g', 'e', '"', ':'>,
+                      json_key_prefix<string_literal<char, 'a', 'g', 'e'>,
+                                      false>::type>::value));
+
+  Root root;
+  std::get<0>(root) = "Ro\"ot\n";
+  std::get<1>(root) = -1234567;
+  std::get<2>(root) = 1.5;
+  std::get<3>(root) = true;
+  std::get<4>(root) = {Child{"A", 0}, Child{"B", 99}};
+  std::get<5>(root) = {{"x", -9000000000}, {"y", 3}};
+  std::get<7>(root) = 18446744073709551615u;
+  CHECK(R"json({"name":"Ro\"ot\n","age":-1234567,"size":1.5,"child1":true,)json"
+        R"json("children":[{"name":"A","age":0},{"name":"B","age":99}],)json"
+        R"json("miles":{"x":-9000000000,"y":3},"list":null,)json"
+        R"json("a\"b":18446744073709551615})json" == to_json(root));
+
+  // Doubles are written back to the same value
+  CHECK("0.1" == to_json(0.1));
+  CHECK(0.1 / 3. == std::strtod(to_json(0.1 / 3.).c_str(), nullptr));
+  CHECK("null" == to_json(std::nan("")));
+  CHECK("[]" == to_json(std::vector<int>{}));
+  CHECK("{}" == to_json(std::map<std::string, int>{}));
+  CHECK("{}" == to_json(named_tuple<>{}));
+  CHECK(R"("\u0001")" == to_json(std::string(1u, '\x01')));
+
+  // The buffer grows past its initial capacity
+  json_buffer buffer(4u);
+  write_json(buffer, std::vector<std::string>(100u, "abcdef"));
+  CHECK(901u == buffer.size());
+}
+
+TEST_CASE("JsonWriter2", "[JsonWriter2]") {
+  using namespace named_types::extensions::generation;
+  using named_types::extensions::parsing::lexical_cast;
+
+  // Numbers keep a '.' whatever the locale
+  comma_locale locale;
+  if (!locale.active) {
+    WARN("No locale with a ',' decimal point is installed");
+    return;
+  }
+  CHECK("1.5" == to_json(1.5));
+  CHECK("0.1" == to_json(0.1f));
+  CHECK("[-2.5,0.75]" == to_json(std::vector<double>{-2.5, 0.75}));
+  CHECK(1. / 3. == lexical_cast<double>(to_json(1. / 3.)));
+}
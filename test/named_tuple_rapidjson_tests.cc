@@ -1,6 +1,8 @@
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <vector>
+#include <deque>
 #include <tuple>
 #include <array>
 #include <functional>
@@ -9,7 +11,11 @@
 #include <named_types/literals/integral_string_literal.hpp>
 #include <named_types/rt_named_tuple.hpp>
 #include <named_types/extensions/rapidjson.hpp>
+#include <named_types/extensions/json_writer.hpp>
+#include <named_types/extensions/rapidjson_parallel.hpp>
+#include <named_types/extensions/rapidjson_push.hpp>
 #include "catch.hpp"
+#include "comma_locale.hpp"
 
 namespace {
 size_t constexpr operator"" _s(const char* c, size_t s) {
@@ -30,6 +36,73 @@ using list = attr<"list"_s>;
 using func = attr<"func"_s>;
 };
 
+// A non owning string
+struct string_ref {
+  char const* data = nullptr;
+  size_t size = 0u;
+  string_ref() = default;
+  string_ref(char const* input, size_t length)
+      : data(input)
+      , size(length) {}
+  std::string str() const { return std::string(data, size); }
+};
+
+namespace named_types {
+template <> struct is_string_view<string_ref> : std::true_type {};
+}
+
+// A map stored as a vector sorted by key, filled unsorted then sorted once
+// per object. The first of duplicate keys is kept.
+template <class T> struct sorted_map : std::vector<std::pair<std::string, T>> {
+  using key_type = std::string;
+  using mapped_type = T;
+  // Objects parsed into the map
+  size_t sorts = 0u;
+
+  T const* find(std::string const& key) const {
+    auto found = std::lower_bound(
+        this->begin(), this->end(), key,
+        [](std::pair<std::string, T> const& entry, std::string const& key) {
+          return entry.first < key;
+        });
+    return this->end() != found && key == found->first ? &found->second
+                                                        : nullptr;
+  }
+};
+
+namespace named_types {
+template <class T>
+struct is_associative_container<sorted_map<T>> : std::true_type {};
+
+namespace extensions {
+namespace parsing {
+template <class T> struct associative_inserter<sorted_map<T>> {
+  static void start(sorted_map<T>&) {}
+
+  static T* emplace(sorted_map<T>& map, std::string key, T&& value) {
+    map.emplace_back(std::move(key), std::move(value));
+    return &map.back().second;
+  }
+
+  static void finish(sorted_map<T>& map) {
+    auto less = [](std::pair<std::string, T> const& left,
+                   std::pair<std::string, T> const& right) {
+      return left.first < right.first;
+    };
+    std::stable_sort(map.begin(), map.end(), less);
+    map.erase(std::unique(map.begin(), map.end(),
+                          [](std::pair<std::string, T> const& left,
+                             std::pair<std::string, T> const& right) {
+                            return left.first == right.first;
+                          }),
+              map.end());
+    ++map.sorts;
+  }
+};
+}
+}
+}
+
 // Testing the factory
 TEST_CASE("RapidJson1", "[RapidJson1]") {
   // using namespace named_types::extensions::parsing;
@@ -119,3 +192,821 @@ TEST_CASE("RapidJson4", "[RapidJson4]") {
   CHECK(reader.Parse(ss, handler));
   CHECK("Marcelo" == data[1].get<name>());
 }
+
+TEST_CASE("RapidJson5", "[RapidJson5]") {
+  using namespace named_types;
+  using named_types::extensions::rapidjson::make_reader_handler;
+
+  using MyTuple = named_tuple<std::string(name),
+                              std::map<std::string, int>(children),
+                              int(age)>;
+
+  MyTuple t1;
+  std::string input1 =
+      R"json({"name":"Marcelo","an_unknown_and_rather_long_key":3,)json"
+      R"json("children":{"a_key_longer_than_small_strings":1,"b":2},)json"
+      R"json("age":57})json";
+  auto handler = make_reader_handler(t1);
+  ::rapidjson::Reader reader;
+  ::rapidjson::StringStream ss(input1.c_str());
+  CHECK(reader.Parse(ss, handler));
+  CHECK("Marcelo" == t1.get<name>());
+  CHECK(57 == t1.get<age>());
+  CHECK(1 == t1.get<children>()["a_key_longer_than_small_strings"]);
+  CHECK(2 == t1.get<children>()["b"]);
+}
+
+TEST_CASE("RapidJsonStatic1", "[RapidJsonStatic1]") {
+  using namespace named_types;
+  using named_types::extensions::rapidjson::make_static_reader_handler;
+
+  using MyTuple = named_tuple<
+      std::string(name),
+      int(age),
+      double(size),
+      named_tuple<std::string(name), size_t(age)>(child1),
+      std::vector<named_tuple<std::string(name), size_t(age)>>(children),
+      std::vector<int>(miles),
+      std::vector<std::vector<int>>(matrix)>;
+
+  MyTuple t1;
+  std::string input1 = R"json({"age":57,"name":"Marcelo","size":1.8,")json"
+                       R"json(child1":{"name":"Coucou","age":3},"children")json"
+                       R"json(:[{"name":"Albertine","age":4}],"miles":[1,)json"
+                       R"json(2,3],"unknown":[4],"matrix":[[1,2],[3,4]]})json";
+  auto handler = make_static_reader_handler(t1);
+  ::rapidjson::Reader reader;
+  ::rapidjson::StringStream ss(input1.c_str());
+  CHECK_FALSE(reader.Parse(ss, handler));
+
+  MyTuple t2;
+  std::string input2 = R"json({"age":57,"name":"Marcelo","size":1.8,")json"
+                       R"json(child1":{"name":"Coucou","age":3},"children")json"
+                       R"json(:[{"name":"Albertine","age":4}],"miles":[1,)json"
+                       R"json(2,3],"other":3,"matrix":[[1,2],[3,4]]})json";
+  auto handler2 = make_static_reader_handler(t2);
+  ::rapidjson::StringStream ss2(input2.c_str());
+  CHECK(reader.Parse(ss2, handler2));
+  CHECK("Marcelo" == t2.get<name>());
+  CHECK(1.8 == t2.get<size>());
+  CHECK(3 == t2.get<child1>().get<age>());
+  CHECK("Albertine" == t2.get<children>()[0].get<name>());
+  CHECK(3u == t2.get<miles>().size());
+  CHECK(4 == t2.get<matrix>()[1][1]);
+}
+
+TEST_CASE("RapidJsonStatic2", "[RapidJsonStatic2]") {
+  using namespace named_types;
+  using named_types::extensions::rapidjson::make_static_reader_handler;
+
+  using MyTuple =
+      named_tuple<std::string(name),
+                  int(age),
+                  std::map<std::string, named_tuple<size_t(age)>>(children)>;
+
+  std::vector<MyTuple> data;
+  std::string input1 =
+      R"json([{"name":"Robert","age":48},{"age":57,"name":"Marcelo",)json"
+      R"json("children":{"Albertine":{"age":4},"Rupert":{"age":5}}}])json";
+  auto handler = make_static_reader_handler(data);
+  ::rapidjson::Reader reader;
+  ::rapidjson::StringStream ss(input1.c_str());
+  CHECK(reader.Parse(ss, handler));
+  REQUIRE(2u == data.size());
+  CHECK("Marcelo" == data[1].get<name>());
+  CHECK(5u == data[1].get<children>()["Rupert"].get<age>());
+}
+
+TEST_CASE("RapidJson6", "[RapidJson6]") {
+  using namespace named_types;
+  using named_types::extensions::rapidjson::make_reader_handler;
+
+  using MyTuple =
+      named_tuple<std::string(name), std::vector<std::vector<int>>(matrix)>;
+
+  // One handler, and its frames, reused over several documents
+  std::vector<MyTuple> data;
+  auto handler = make_reader_handler(data);
+  ::rapidjson::Reader reader;
+  std::string input1 = R"json([{"name":"Robert","matrix":[[1],[2,3]]}])json";
+  std::string input2 = R"json([{"name":"Marcelo","matrix":[[4]]},{}])json";
+  ::rapidjson::StringStream ss1(input1.c_str());
+  CHECK(reader.Parse(ss1, handler));
+  ::rapidjson::StringStream ss2(input2.c_str());
+  CHECK(reader.Parse(ss2, handler));
+  REQUIRE(3u == data.size());
+  CHECK(3 == data[0].get<matrix>()[1][1]);
+  CHECK("Marcelo" == data[1].get<name>());
+  CHECK(4 == data[1].get<matrix>()[0][0]);
+}
+
+TEST_CASE("RapidJson7", "[RapidJson7]") {
+  using namespace named_types;
+  using named_types::extensions::rapidjson::make_reader_handler;
+  using named_types::extensions::rapidjson::make_static_reader_handler;
+
+  using MyTuple = named_tuple<std::string(name),
+                              string_ref(child1),
+                              std::vector<string_ref>(list),
+                              std::vector<std::string>(children)>;
+
+  // Strings are copied with their length, embedded NULs included
+  std::string input1 =
+      R"json({"name":"Mar\u0000celo","child1":"Coucou","list":["a","bc"],)json"
+      R"json("children":["Rob\u0000ert"]})json";
+  MyTuple t1;
+  auto handler = make_reader_handler(t1);
+  ::rapidjson::Reader reader;
+  ::rapidjson::StringStream ss1(input1.c_str());
+  CHECK(reader.Parse(ss1, handler));
+  CHECK(std::string("Mar\0celo", 8u) == t1.get<name>());
+  CHECK(std::string("Rob\0ert", 7u) == t1.get<children>()[0]);
+  // Views are not set from transient strings
+  CHECK(nullptr == t1.get<child1>().data);
+  CHECK(t1.get<list>().empty());
+
+  // In situ parsing : views point into the input buffer
+  for (int is_static = 0; is_static < 2; ++is_static) {
+    std::vector<char> buffer(input1.begin(), input1.end());
+    buffer.push_back('\0');
+    MyTuple t2;
+    ::rapidjson::InsituStringStream ss2(buffer.data());
+    if (is_static) {
+      auto static_handler = make_static_reader_handler(t2);
+      CHECK(reader.Parse<::rapidjson::kParseInsituFlag>(ss2, static_handler));
+    } else {
+      auto dynamic_handler = make_reader_handler(t2);
+      CHECK(reader.Parse<::rapidjson::kParseInsituFlag>(ss2, dynamic_handler));
+    }
+    CHECK("Coucou" == t2.get<child1>().str());
+    CHECK(static_cast<void const*>(t2.get<child1>().data) >=
+          static_cast<void const*>(buffer.data()));
+    CHECK(static_cast<void const*>(t2.get<child1>().data) <
+          static_cast<void const*>(buffer.data() + buffer.size()));
+    REQUIRE(2u == t2.get<list>().size());
+    CHECK("bc" == t2.get<list>()[1].str());
+    CHECK(std::string("Mar\0celo", 8u) == t2.get<name>());
+  }
+}
+
+TEST_CASE("RapidJson8", "[RapidJson8]") {
+  using namespace named_types;
+  using named_types::extensions::rapidjson::make_static_reader_handler;
+  using named_types::extensions::generation::to_json;
+
+  // What is written is read back
+  using Child = named_tuple<std::string(name), std::vector<double>(list)>;
+  using MyTuple = named_tuple<std::string(name),
+                              int64_t(age),
+                              double(size),
+                              std::vector<Child>(children),
+                              std::map<std::string, int>(miles)>;
+  MyTuple t1;
+  t1.get<name>() = "Mar\"ce\\lo\t";
+  t1.get<age>() = -4000000000;
+  t1.get<size>() = 0.1 / 3.;
+  t1.get<children>().push_back(Child{"Robert", {1e300, -2.5e-8}});
+  t1.get<children>().push_back(Child{"", {}});
+  t1.get<miles>() = {{"a", 1}, {"b\n", 2}};
+
+  std::string output = to_json(t1);
+  MyTuple t2;
+  auto handler = make_static_reader_handler(t2);
+  ::rapidjson::Reader reader;
+  ::rapidjson::StringStream ss(output.c_str());
+  CHECK(reader.Parse(ss, handler));
+  CHECK(t1.get<name>() == t2.get<name>());
+  CHECK(t1.get<age>() == t2.get<age>());
+  CHECK(t1.get<size>() == t2.get<size>());
+  REQUIRE(2u == t2.get<children>().size());
+  CHECK("Robert" == t2.get<children>()[0].get<name>());
+  CHECK(t1.get<children>()[0].get<list>() ==
+        t2.get<children>()[0].get<list>());
+  CHECK(t2.get<children>()[1].get<list>().empty());
+  CHECK(t1.get<miles>() == t2.get<miles>());
+  CHECK(output == to_json(t2));
+}
+
+TEST_CASE("RapidJson9", "[RapidJson9]") {
+  using namespace named_types;
+  using named_types::extensions::rapidjson::parse_ndjson;
+  using named_types::extensions::rapidjson::static_reader_handler;
+
+  using MyTuple =
+      named_tuple<std::string(name), int(age), std::vector<int>(list)>;
+  std::string input = "{\"name\":\"Marcelo\",\"age\":57,\"list\":[1,2]}\n"
+                      "{\"name\":\"Roger\",\"age\":\n"
+                      "\r\n"
+                      "{\"name\":\"Robert\",\"age\":12}\r\n"
+                      "[1,2]\n"
+                      "{\"age\":3}";
+
+  for (int is_static = 0; is_static < 2; ++is_static) {
+    std::vector<MyTuple> output;
+    auto result = is_static ? parse_ndjson<static_reader_handler>(input, output)
+                            : parse_ndjson(input, output);
+    CHECK(3u == result.records);
+    CHECK_FALSE(result.ok());
+    REQUIRE(2u == result.errors.size());
+    CHECK(2u == result.errors[0].line);
+    CHECK(5u == result.errors[1].line);
+    // Handler refusals are reported past the opening bracket
+    CHECK(input.find("[1,2]\n") + 1u == result.errors[1].offset);
+
+    // Failed lines leave no record
+    REQUIRE(3u == output.size());
+    CHECK("Marcelo" == output[0].get<name>());
+    CHECK(2u == output[0].get<list>().size());
+    CHECK("Robert" == output[1].get<name>());
+    CHECK(12 == output[1].get<age>());
+    CHECK(3 == output[2].get<age>());
+  }
+}
+
+TEST_CASE("RapidJson10", "[RapidJson10]") {
+  using namespace named_types;
+  using named_types::extensions::rapidjson::parse_ndjson;
+  using named_types::extensions::rapidjson::parse_ndjson_parallel;
+  using named_types::extensions::rapidjson::static_reader_handler;
+
+  using MyTuple = named_tuple<std::string(name), int(age)>;
+  std::string input;
+  for (int index = 0; index < 20000; ++index) {
+    input += 0 == index % 1000
+                 ? "{\"name\":\"broken\",\"age\":}\n"
+                 : "{\"name\":\"Record number " + std::to_string(index) +
+                       "\",\"age\":" + std::to_string(index) + "}\n";
+  }
+
+  std::vector<MyTuple> expected;
+  auto expected_result = parse_ndjson(input, expected);
+  REQUIRE(19980u == expected.size());
+
+  for (int keep_order = 0; keep_order < 2; ++keep_order) {
+    std::vector<MyTuple> output;
+    auto result = parse_ndjson_parallel<static_reader_handler>(
+        input, output, 4u, 1 == keep_order);
+    CHECK(20000u == result.lines);
+    CHECK(expected.size() == result.records);
+    REQUIRE(expected_result.errors.size() == result.errors.size());
+    for (size_t index = 0; index < result.errors.size(); ++index) {
+      CHECK(expected_result.errors[index].line == result.errors[index].line);
+      CHECK(expected_result.errors[index].offset ==
+            result.errors[index].offset);
+    }
+    REQUIRE(expected.size() == output.size());
+    if (!keep_order) {
+      std::sort(output.begin(), output.end(),
+                [](MyTuple const& left, MyTuple const& right) {
+                  return left.get<age>() < right.get<age>();
+                });
+    }
+    CHECK(expected == output);
+  }
+}
+
+TEST_CASE("RapidJson11", "[RapidJson11]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::unknown_keys;
+  using named_types::extensions::rapidjson::make_reader_handler;
+  using named_types::extensions::rapidjson::make_static_reader_handler;
+  using named_types::extensions::rapidjson::parse_ndjson;
+  using named_types::extensions::rapidjson::static_reader_handler;
+
+  using MyTuple = named_tuple<
+      std::string(name),
+      int(age),
+      std::vector<named_tuple<std::string(name), size_t(age)>>(children),
+      std::vector<int>(miles)>;
+
+  // Skipped values hold keys of the schema, and objects of a wrong kind
+  std::string input = R"json({"name":"Marcelo","unknown":{"age":3,"x":[)json"
+                      R"json({"name":"Roger"},[[]]]},"age":57,"children":)json"
+                      R"json([{"name":"Albertine","age":{"age":8}},{"age")json"
+                      R"json(:4}],"extra":[[1],{"age":2}],"miles":[1,[2],)json"
+                      R"json(3]})json";
+  ::rapidjson::Reader reader;
+  for (int is_static = 0; is_static < 2; ++is_static) {
+    MyTuple t1;
+    ::rapidjson::StringStream ss1(input.c_str());
+    if (is_static) {
+      auto handler = make_static_reader_handler(t1);
+      CHECK_FALSE(reader.Parse(ss1, handler));
+    } else {
+      auto handler = make_reader_handler(t1);
+      CHECK_FALSE(reader.Parse(ss1, handler));
+    }
+
+    MyTuple t2;
+    ::rapidjson::StringStream ss2(input.c_str());
+    if (is_static) {
+      auto handler = make_static_reader_handler(t2, unknown_keys::skip);
+      CHECK(reader.Parse(ss2, handler));
+    } else {
+      auto handler = make_reader_handler(t2, unknown_keys::skip);
+      CHECK(reader.Parse(ss2, handler));
+    }
+    CHECK("Marcelo" == t2.get<name>());
+    CHECK(57 == t2.get<age>());
+    REQUIRE(2u == t2.get<children>().size());
+    CHECK("Albertine" == t2.get<children>()[0].get<name>());
+    CHECK(0u == t2.get<children>()[0].get<age>());
+    CHECK(4u == t2.get<children>()[1].get<age>());
+    CHECK((std::vector<int>{1, 3}) == t2.get<miles>());
+
+    // The root still has to match
+    std::vector<int> t3;
+    ::rapidjson::StringStream ss3(input.c_str());
+    if (is_static) {
+      auto handler = make_static_reader_handler(t3, unknown_keys::skip);
+      CHECK_FALSE(reader.Parse(ss3, handler));
+    } else {
+      auto handler = make_reader_handler(t3, unknown_keys::skip);
+      CHECK_FALSE(reader.Parse(ss3, handler));
+    }
+  }
+
+  std::string lines = "{\"age\":1,\"new\":{\"list\":[1,2]}}\n"
+                      "{\"new\":[{}],\"age\":2}\n";
+  for (int is_static = 0; is_static < 2; ++is_static) {
+    std::vector<MyTuple> output;
+    auto result =
+        is_static
+            ? parse_ndjson<static_reader_handler>(lines, output,
+                                                  unknown_keys::skip)
+            : parse_ndjson(lines, output, unknown_keys::skip);
+    CHECK(result.ok());
+    REQUIRE(2u == output.size());
+    CHECK(1 == output[0].get<age>());
+    CHECK(2 == output[1].get<age>());
+  }
+}
+
+TEST_CASE("RapidJson12", "[RapidJson12]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::parse_mode;
+  using named_types::extensions::parsing::unknown_keys;
+  using named_types::extensions::rapidjson::make_reader_handler;
+  using named_types::extensions::rapidjson::make_static_reader_handler;
+
+  using Child = named_tuple<std::string(name), size_t(age)>;
+  using MyTuple = named_tuple<std::string(name),
+                              int(age),
+                              std::vector<Child>(children),
+                              std::vector<std::string>(list),
+                              std::vector<int>(miles),
+                              std::map<std::string, int>(child1)>;
+
+  std::string input1 =
+      R"json({"name":"A name longer than small strings","age":57,)json"
+      R"json("children":[{"name":"A first child with a long name","age":3},)json"
+      R"json({"name":"A second child with a long name","age":4}],"list":)json"
+      R"json(["A first element of the list","A second element of the )json"
+      R"json(list"],"miles":[1,2,3],"child1":{"a":1}})json";
+  std::string input2 =
+      R"json({"name":"Another name, longer than small strings","age":58,)json"
+      R"json("children":[{"name":"A first child with a long game","age":5})json"
+      R"json(,{"name":"A second child with a long game","age":6}],"list":)json"
+      R"json(["A first element, of the list","A second element, of the )json"
+      R"json(list"],"miles":[4,5,6],"child1":{"b":2}})json";
+  std::string input3 = R"json({"age":1,"children":[{"name":"x"}],"miles":[7]})json";
+
+  ::rapidjson::Reader reader;
+  for (int is_static = 0; is_static < 2; ++is_static) {
+    MyTuple t1;
+    auto parse = [&](std::string const& input, parse_mode mode) {
+      ::rapidjson::StringStream ss(input.c_str());
+      if (is_static) {
+        auto handler = make_static_reader_handler(t1, unknown_keys::fail, mode);
+        return reader.Parse(ss, handler);
+      }
+      auto handler = make_reader_handler(t1, unknown_keys::fail, mode);
+      return reader.Parse(ss, handler);
+    };
+
+    // Merging appends and keeps map entries
+    REQUIRE(parse(input1, parse_mode::merge));
+    REQUIRE(parse(input2, parse_mode::merge));
+    CHECK(4u == t1.get<children>().size());
+    CHECK(6u == t1.get<miles>().size());
+    CHECK(2u == t1.get<child1>().size());
+
+    // Reusing overwrites in place
+    REQUIRE(parse(input1, parse_mode::reuse));
+    CHECK(2u == t1.get<children>().size());
+    void const* name_data = t1.get<name>().data();
+    void const* children_data = t1.get<children>().data();
+    void const* child_name_data = t1.get<children>()[1].get<name>().data();
+    void const* list_data = t1.get<list>().data();
+    void const* element_data = t1.get<list>()[1].data();
+    void const* miles_data = t1.get<miles>().data();
+
+    REQUIRE(parse(input2, parse_mode::reuse));
+    CHECK("Another name, longer than small strings" == t1.get<name>());
+    CHECK(58 == t1.get<age>());
+    REQUIRE(2u == t1.get<children>().size());
+    CHECK("A second child with a long game" ==
+          t1.get<children>()[1].get<name>());
+    CHECK(6u == t1.get<children>()[1].get<age>());
+    REQUIRE(2u == t1.get<list>().size());
+    CHECK("A second element, of the list" == t1.get<list>()[1]);
+    CHECK((std::vector<int>{4, 5, 6}) == t1.get<miles>());
+    REQUIRE(1u == t1.get<child1>().size());
+    CHECK(2 == t1.get<child1>()["b"]);
+    CHECK(name_data == static_cast<void const*>(t1.get<name>().data()));
+    CHECK(children_data ==
+          static_cast<void const*>(t1.get<children>().data()));
+    CHECK(child_name_data == static_cast<void const*>(
+                                 t1.get<children>()[1].get<name>().data()));
+    CHECK(list_data == static_cast<void const*>(t1.get<list>().data()));
+    CHECK(element_data == static_cast<void const*>(t1.get<list>()[1].data()));
+    CHECK(miles_data == static_cast<void const*>(t1.get<miles>().data()));
+
+    // Missing fields and elements are reset
+    REQUIRE(parse(input3, parse_mode::reuse));
+    CHECK(t1.get<name>().empty());
+    CHECK(1 == t1.get<age>());
+    REQUIRE(1u == t1.get<children>().size());
+    CHECK("x" == t1.get<children>()[0].get<name>());
+    CHECK(0u == t1.get<children>()[0].get<age>());
+    CHECK(t1.get<list>().empty());
+    CHECK((std::vector<int>{7}) == t1.get<miles>());
+    CHECK(t1.get<child1>().empty());
+    CHECK(children_data ==
+          static_cast<void const*>(t1.get<children>().data()));
+  }
+}
+
+TEST_CASE("RapidJson13", "[RapidJson13]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::projection_t;
+  using named_types::extensions::parsing::unknown_keys;
+  using named_types::extensions::rapidjson::make_projection_handler;
+  using named_types::extensions::rapidjson::make_reader_handler;
+
+  using Record = named_tuple<std::string(name),
+                             int(age),
+                             double(size),
+                             std::vector<int>(miles),
+                             std::map<std::string, int>(children)>;
+  using Projection = projection_t<Record, miles, name>;
+  static_assert(std::is_same<Projection,
+                             named_tuple<std::vector<int>(miles),
+                                         std::string(name)>>::value,
+                "Projections keep the types of the record");
+
+  std::string input = R"json({"age":57,"name":"Marcelo","size":1.8,)json"
+                      R"json("children":{"a":1},"miles":[1,2],"list":)json"
+                      R"json([{"name":"Roger"}],"name2":"x"})json";
+  ::rapidjson::Reader reader;
+  for (int is_static = 0; is_static < 2; ++is_static) {
+    Projection projected;
+    ::rapidjson::StringStream ss(input.c_str());
+    if (is_static) {
+      auto handler = make_projection_handler(projected);
+      CHECK(reader.Parse(ss, handler));
+    } else {
+      auto handler = make_reader_handler(projected, unknown_keys::skip);
+      CHECK(reader.Parse(ss, handler));
+    }
+    CHECK("Marcelo" == projected.get<name>());
+    CHECK((std::vector<int>{1, 2}) == projected.get<miles>());
+
+    // Injected into a record, other fields are untouched
+    Record record;
+    record.get<age>() = 12;
+    record = std::move(projected);
+    CHECK("Marcelo" == record.get<name>());
+    CHECK(2u == record.get<miles>().size());
+    CHECK(12 == record.get<age>());
+    CHECK(record.get<children>().empty());
+  }
+}
+
+TEST_CASE("RapidJson14", "[RapidJson14]") {
+  using namespace named_types;
+  using named_types::extensions::rapidjson::json_validator;
+  using named_types::extensions::rapidjson::schema_violation;
+  using named_types::extensions::rapidjson::validate_json;
+
+  using Child = named_tuple<std::string(name), int(age)>;
+  using Record = named_tuple<std::string(name),
+                             int(age),
+                             double(size),
+                             std::vector<int>(miles),
+                             std::map<std::string, int>(children),
+                             std::vector<Child>(list)>;
+
+  auto valid = validate_json<Record>(
+      R"json({"name":"Marcelo","age":57,"size":2,"miles":[1,2],)json"
+      R"json("children":{"a":1,"b":2},"list":[{"name":"Roger","age":1}]})json");
+  CHECK(valid);
+  CHECK(schema_violation::none == valid.violation);
+
+  // Offsets are just past the offending token
+  json_validator<Record> validator;
+  auto unknown = validator.validate(R"json({"name":"a","nope":1})json");
+  CHECK(!unknown);
+  CHECK(schema_violation::unknown_key == unknown.violation);
+  CHECK(18u == unknown.offset);
+
+  auto value = validator.validate(R"json({"age":57,"name":1})json");
+  CHECK(schema_violation::unexpected_value == value.violation);
+  CHECK(18u == value.offset);
+  CHECK(schema_violation::unexpected_value ==
+        validator.validate(R"json({"age":"57"})json").violation);
+  CHECK(schema_violation::unexpected_value ==
+        validator.validate(R"json({"list":[{"name":2}]})json").violation);
+
+  auto object = validator.validate(R"json({"age":{}})json");
+  CHECK(schema_violation::unexpected_object == object.violation);
+  CHECK(8u == object.offset);
+  CHECK(schema_violation::unexpected_array ==
+        validator.validate(R"json({"miles":[[1]]})json").violation);
+  CHECK(schema_violation::unexpected_object ==
+        validator.validate(R"json({"children":{"a":{}}})json").violation);
+  CHECK(schema_violation::unexpected_array ==
+        validator.validate(R"json([])json").violation);
+  CHECK(schema_violation::unknown_key ==
+        validator.validate(R"json({"list":[{"size":1}]})json").violation);
+
+  // Syntax errors are reported without violation
+  auto syntax = validator.validate(R"json({"name":"a",})json");
+  CHECK(!syntax);
+  CHECK(schema_violation::none == syntax.violation);
+  CHECK(validator.validate(R"json({"miles":[],"children":{}})json"));
+}
+
+TEST_CASE("RapidJson15", "[RapidJson15]") {
+  using namespace named_types;
+  using named_types::extensions::rapidjson::make_push_parser;
+  using named_types::extensions::rapidjson::make_reader_handler;
+  using named_types::extensions::rapidjson::make_static_reader_handler;
+  using named_types::extensions::rapidjson::push_status;
+
+  using Record = named_tuple<std::string(name),
+                             int(age),
+                             double(size),
+                             std::vector<int64_t>(miles),
+                             std::map<std::string, bool>(children)>;
+
+  std::string input =
+      R"json([{"name":"Fran\u00e7ois \"\ud83d\ude00\" \\o/", "age" : -57,)json"
+      R"json( "size":1.5e1,"miles":[0,4294967296,-2147483649],)json"
+      R"json("children":{"a":true,"b":false}},{"age":12,"name":""}])json";
+  std::vector<Record> expected(2u);
+  expected[0] = Record("Fran\xc3\xa7ois \"\xf0\x9f\x98\x80\" \\o/", -57,
+                       15., std::vector<int64_t>{0, 4294967296, -2147483649},
+                       std::map<std::string, bool>{{"a", true}, {"b", false}});
+  expected[1].get<age>() = 12;
+
+  // Any chunk size, down to one byte per chunk
+  size_t const first_end = input.find("}}") + 2u;
+  for (size_t chunk_size = 1u; chunk_size <= input.size(); ++chunk_size) {
+    for (int is_static = 0; is_static < 2; ++is_static) {
+      std::vector<Record> output;
+      auto handler = make_reader_handler(output);
+      auto static_handler = make_static_reader_handler(output);
+      auto parser = make_push_parser(handler);
+      auto static_parser = make_push_parser(static_handler);
+      push_status status = push_status::incomplete;
+      for (size_t begin = 0u; begin < input.size(); begin += chunk_size) {
+        size_t length = std::min(chunk_size, input.size() - begin);
+        status = is_static ? static_parser.feed(input.data() + begin, length)
+                           : parser.feed(input.data() + begin, length);
+        REQUIRE(push_status::failed != status);
+        // The first record is done once its closing brace is fed
+        if (begin < first_end && first_end <= begin + length) {
+          REQUIRE(1u <= output.size());
+          CHECK(expected[0] == output[0]);
+        }
+      }
+      CHECK(push_status::complete == status);
+      CHECK(push_status::complete ==
+            (is_static ? static_parser.finish() : parser.finish()));
+      CHECK(expected == output);
+    }
+  }
+
+  // A number at the root is only complete at the end of the input
+  std::vector<int> numbers;
+  auto handler = make_reader_handler(numbers);
+  auto parser = make_push_parser(handler);
+  CHECK(push_status::incomplete == parser.feed("[1, 2"));
+  CHECK(push_status::incomplete == parser.feed("3,  4"));
+  CHECK(push_status::complete == parser.feed("] "));
+  CHECK((std::vector<int>{1, 23, 4}) == numbers);
+  CHECK(push_status::failed == parser.feed("[5]"));
+  CHECK(::rapidjson::kParseErrorDocumentRootNotSingular == parser.code());
+  CHECK(12u == parser.offset());
+
+  // Errors are reported at the first offending byte
+  handler.reset(numbers);
+  parser.reset();
+  CHECK(push_status::incomplete == parser.feed("[1, 2"));
+  CHECK(push_status::failed == parser.finish());
+  CHECK(::rapidjson::kParseErrorArrayMissCommaOrSquareBracket == parser.code());
+  handler.reset(numbers);
+  parser.reset();
+  CHECK(push_status::failed == parser.feed("[1, \"a\\x\"]"));
+  CHECK(::rapidjson::kParseErrorStringEscapeInvalid == parser.code());
+  CHECK(7u == parser.offset());
+  handler.reset(numbers);
+  parser.reset();
+  CHECK(push_status::incomplete == parser.feed("[tr"));
+  CHECK(push_status::failed == parser.feed("ie]"));
+  CHECK(::rapidjson::kParseErrorValueInvalid == parser.code());
+  CHECK(3u == parser.offset());
+  handler.reset(numbers);
+  parser.reset();
+  CHECK(push_status::failed == parser.feed("[1.]"));
+  CHECK(::rapidjson::kParseErrorNumberMissFraction == parser.code());
+}
+
+TEST_CASE("RapidJson16", "[RapidJson16]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::parse_mode;
+  using named_types::extensions::parsing::unknown_keys;
+  using named_types::extensions::rapidjson::make_reader_handler;
+  using named_types::extensions::rapidjson::make_static_reader_handler;
+
+  using Child = named_tuple<std::string(name), int(age)>;
+  using Record = named_tuple<std::array<double, 3>(size),
+                             small_vector<int, 4>(miles),
+                             small_vector<Child, 2>(children)>;
+
+  auto parse = [](std::string const& input, Record& record, bool is_static,
+                  parse_mode mode) {
+    ::rapidjson::Reader reader;
+    ::rapidjson::StringStream ss(input.c_str());
+    if (is_static) {
+      auto handler =
+          make_static_reader_handler(record, unknown_keys::skip, mode);
+      return !reader.Parse(ss, handler).IsError();
+    }
+    auto handler = make_reader_handler(record, unknown_keys::skip, mode);
+    return !reader.Parse(ss, handler).IsError();
+  };
+
+  for (int is_static = 0; is_static < 2; ++is_static) {
+    Record record;
+    REQUIRE(parse(R"json({"size":[1.5,2.5,3.5],"miles":[1,2,3],)json"
+                  R"json("children":[{"name":"Roger","age":4}]})json",
+                  record, is_static, parse_mode::merge));
+    CHECK((std::array<double, 3>{{1.5, 2.5, 3.5}}) == record.get<size>());
+    CHECK((small_vector<int, 4>{1, 2, 3}) == record.get<miles>());
+    REQUIRE(1u == record.get<children>().size());
+    CHECK("Roger" == record.get<children>()[0].get<name>());
+    CHECK(4 == record.get<children>()[0].get<age>());
+
+    // Arrays are filled by position, merging keeps their tail
+    REQUIRE(parse(R"json({"size":[7],"miles":[4]})json", record, is_static,
+                  parse_mode::merge));
+    CHECK((std::array<double, 3>{{7., 2.5, 3.5}}) == record.get<size>());
+    CHECK((small_vector<int, 4>{1, 2, 3, 4}) == record.get<miles>());
+
+    // Reusing resets the tail of arrays and truncates the other sequences
+    REQUIRE(parse(R"json({"size":[8],"miles":[5,6],"children":[]})json",
+                  record, is_static, parse_mode::reuse));
+    CHECK((std::array<double, 3>{{8., 0., 0.}}) == record.get<size>());
+    CHECK((small_vector<int, 4>{5, 6}) == record.get<miles>());
+    CHECK(record.get<children>().empty());
+
+    // Elements past the capacity fail, even when skipping unknown keys
+    Record overflow;
+    CHECK(!parse(R"json({"size":[1,2,3,4]})json", overflow, is_static,
+                 parse_mode::merge));
+    CHECK(!parse(R"json({"miles":[1,2,3,4,5]})json", overflow, is_static,
+                 parse_mode::reuse));
+    CHECK(!parse(R"json({"children":[{},{},{"name":"x"}]})json", overflow,
+                 is_static, parse_mode::merge));
+    CHECK(2u == overflow.get<children>().size());
+    CHECK(!parse(R"json({"miles":[1,2,3,4,5,6,7,8]})json", overflow,
+                 is_static, parse_mode::merge));
+    CHECK(4u == overflow.get<miles>().size());
+    CHECK(!parse(R"json({"miles":[9]})json", overflow, is_static,
+                 parse_mode::merge));
+    CHECK((small_vector<int, 4>{1, 2, 3, 4}) == overflow.get<miles>());
+  }
+}
+
+TEST_CASE("RapidJson17", "[RapidJson17]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::parse_mode;
+  using named_types::extensions::parsing::unknown_keys;
+  using named_types::extensions::rapidjson::make_reader_handler;
+  using named_types::extensions::rapidjson::make_static_reader_handler;
+
+  using Child = named_tuple<std::string(name), std::deque<int>(miles)>;
+  using Reversed = std::map<std::string, int, std::greater<std::string>>;
+  using Record = named_tuple<sorted_map<int>(size),
+                             sorted_map<Child>(children),
+                             Reversed(child1),
+                             std::deque<Child>(list)>;
+  static_assert(is_associative_container<std::unordered_map<
+                    std::string, int, std::hash<std::string>>>::value,
+                "Maps match whatever their parameters");
+
+  auto parse = [](std::string const& input, Record& record, bool is_static,
+                  parse_mode mode) {
+    ::rapidjson::Reader reader;
+    ::rapidjson::StringStream ss(input.c_str());
+    if (is_static) {
+      auto handler =
+          make_static_reader_handler(record, unknown_keys::fail, mode);
+      return !reader.Parse(ss, handler).IsError();
+    }
+    auto handler = make_reader_handler(record, unknown_keys::fail, mode);
+    return !reader.Parse(ss, handler).IsError();
+  };
+
+  for (int is_static = 0; is_static < 2; ++is_static) {
+    Record record;
+    REQUIRE(parse(R"json({"size":{"c":3,"a":1,"b":2,"a":4},)json"
+                  R"json("children":{"y":{"name":"Y","miles":[1,2]},)json"
+                  R"json("x":{"name":"X"}},"child1":{"a":1,"b":2},)json"
+                  R"json("list":[{"miles":[3]},{"name":"Z"}]})json",
+                  record, is_static, parse_mode::merge));
+    sorted_map<int> const& sizes = record.get<size>();
+    REQUIRE(3u == sizes.size());
+    CHECK(1u == sizes.sorts);
+    CHECK("a" == sizes[0].first);
+    CHECK(1 == sizes[0].second);
+    CHECK("c" == sizes[2].first);
+    REQUIRE(nullptr != sizes.find("b"));
+    CHECK(2 == *sizes.find("b"));
+
+    REQUIRE(2u == record.get<children>().size());
+    Child const* y = record.get<children>().find("y");
+    REQUIRE(nullptr != y);
+    CHECK("Y" == y->get<name>());
+    CHECK((std::deque<int>{1, 2}) == y->get<miles>());
+    CHECK("x" == record.get<children>()[0].first);
+
+    CHECK("b" == record.get<child1>().begin()->first);
+    REQUIRE(2u == record.get<list>().size());
+    CHECK((std::deque<int>{3}) == record.get<list>()[0].get<miles>());
+    CHECK("Z" == record.get<list>()[1].get<name>());
+
+    REQUIRE(parse(R"json({"size":{"d":5},"list":[{"name":"W"}]})json",
+                  record, is_static, parse_mode::reuse));
+    REQUIRE(1u == record.get<size>().size());
+    CHECK("d" == record.get<size>()[0].first);
+    CHECK(record.get<children>().empty());
+    REQUIRE(1u == record.get<list>().size());
+    CHECK("W" == record.get<list>()[0].get<name>());
+    CHECK(record.get<list>()[0].get<miles>().empty());
+  }
+}
+
+TEST_CASE("RapidJson18", "[RapidJson18]") {
+  using namespace named_types;
+  using named_types::extensions::rapidjson::make_reader_handler;
+  using named_types::extensions::rapidjson::make_static_reader_handler;
+
+  using MyTuple = named_tuple<std::string(name),
+                              int(age),
+                              std::vector<std::string>(children),
+                              std::map<std::string, std::string>(matrix)>;
+
+  // Strings are not assigned null, the value is ignored by both handlers
+  std::string input = R"json({"name":null,"age":3,"children":[null,"a"],)json"
+                      R"json("matrix":{"b":null,"c":"d"}})json";
+  for (int is_static = 0; is_static < 2; ++is_static) {
+    MyTuple t1;
+    t1.get<name>() = "Roger";
+    ::rapidjson::Reader reader;
+    ::rapidjson::StringStream stream(input.c_str());
+    if (is_static) {
+      auto handler = make_static_reader_handler(t1);
+      CHECK(reader.Parse(stream, handler));
+    } else {
+      auto handler = make_reader_handler(t1);
+      CHECK(reader.Parse(stream, handler));
+    }
+    CHECK("Roger" == t1.get<name>());
+    CHECK(3 == t1.get<age>());
+    CHECK((std::vector<std::string>{"a"}) == t1.get<children>());
+    REQUIRE(1u == t1.get<matrix>().size());
+    CHECK("d" == t1.get<matrix>()["c"]);
+  }
+}
+
+TEST_CASE("RapidJson19", "[RapidJson19]") {
+  using named_types::extensions::rapidjson::make_push_parser;
+  using named_types::extensions::rapidjson::make_reader_handler;
+  using named_types::extensions::rapidjson::push_status;
+
+  // Numbers are read with a '.' whatever the locale
+  comma_locale locale;
+  if (!locale.active) {
+    WARN("No locale with a ',' decimal point is installed");
+    return;
+  }
+  std::vector<double> numbers;
+  auto handler = make_reader_handler(numbers);
+  auto parser = make_push_parser(handler);
+  CHECK(push_status::incomplete == parser.feed("[1.5, -2."));
+  CHECK(push_status::complete == parser.feed("5e-3, 0.75]"));
+  CHECK((std::vector<double>{1.5, -2.5e-3, 0.75}) == numbers);
+}
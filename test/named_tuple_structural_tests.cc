@@ -0,0 +1,629 @@
+#include <array>
+#include <deque>
+#include <functional>
+#include <list>
+#include <map>
+#include <string>
+#include <vector>
+#include <named_types/named_tuple.hpp>
+#include <named_types/literals/integral_string_literal.hpp>
+#include <named_types/extensions/structural_parser.hpp>
+#include "catch.hpp"
+#include "comma_locale.hpp"
+
+namespace {
+size_t constexpr operator"" _s(const char* c, size_t s) {
+  return named_types::basic_lowcase_charset_format::encode(c, s);
+}
+template <size_t EncStr>
+using attr = named_types::named_tag<
+    typename named_types::basic_lowcase_charset_format::decode<EncStr>::type>;
+
+using name = attr<"name"_s>;
+using age = attr<"age"_s>;
+using size = attr<"size"_s>;
+using children = attr<"children"_s>;
+using child1 = attr<"child1"_s>;
+using matrix = attr<"matrix"_s>;
+using miles = attr<"miles"_s>;
+using list = attr<"list"_s>;
+using func = attr<"func"_s>;
+};
+
+// A non owning string
+struct string_ref {
+  char const* data = nullptr;
+  size_t size = 0u;
+  string_ref() = default;
+  string_ref(char const* input, size_t length)
+      : data(input)
+      , size(length) {}
+  std::string str() const { return std::string(data, size); }
+};
+
+namespace named_types {
+template <> struct is_string_view<string_ref> : std::true_type {};
+}
+
+// The cases of the rapidjson handlers
+
+TEST_CASE("Structural1", "[Structural1]") {
+  using named_types::extensions::parsing::parse_json;
+
+  using Tuple = named_types::named_tuple<std::string(name),
+                                         int(age),
+                                         double(size),
+                                         std::vector<int>(list),
+                                         std::function<int(int)>(func)>;
+
+  std::string input = R"json({"age":57,"name":"Marcelo","size":1.8})json";
+  Tuple output{"Roger", 52, 1.9, {}, nullptr};
+  CHECK(parse_json(input, output));
+  CHECK("Marcelo" == named_types::get<name>(output));
+  CHECK(57 == named_types::get<age>(output));
+  CHECK(1.8 == named_types::get<size>(output));
+}
+
+TEST_CASE("Structural2", "[Structural2]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::parse_json;
+
+  using MyTuple = named_tuple<
+      std::string(name),
+      int(age),
+      double(size),
+      named_tuple<std::string(name), size_t(age)>(child1),
+      std::vector<named_tuple<std::string(name), size_t(age)>>(children),
+      std::vector<int>(miles),
+      std::vector<std::vector<int>>(matrix)>;
+
+  MyTuple t1;
+  std::string input1 = R"json({"age":57,"name":"Marcelo","size":1.8,")json"
+                       R"json(child1":{"name":"Coucou","age":3},"children")json"
+                       R"json(:[{"name":"Albertine","age":4}],"miles":[1,)json"
+                       R"json(2,3],"matrix":[[1,2],[3,4]]})json";
+  CHECK(parse_json(input1, t1));
+  CHECK(3 == t1.get<child1>().get<age>());
+  CHECK("Albertine" == t1.get<children>()[0].get<name>());
+  CHECK(4 == t1[children()][0][age()]);
+  CHECK(4 == t1.get<matrix>()[1][1]);
+
+  // Unknown scalars are ignored, unknown objects and arrays are not
+  MyTuple t2;
+  std::string input2 =
+      R"json({"age":57,"other":3,"miles":[1,2],"unknown":[4]})json";
+  auto result = parse_json(input2, t2);
+  CHECK_FALSE(result);
+  CHECK(named_types::extensions::parsing::structural_error::unexpected_value ==
+        result.error);
+  CHECK(input2.find("[4]") == result.offset);
+  CHECK(57 == t2.get<age>());
+}
+
+TEST_CASE("Structural3", "[Structural3]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::parse_json;
+
+  using MyTuple =
+      named_tuple<std::string(name),
+                  int(age),
+                  double(size),
+                  std::map<std::string, named_tuple<size_t(age)>>(children)>;
+
+  MyTuple t1;
+  std::string input1 = R"json({"age":57,"name":"Marcelo","size":1.8,")json"
+                       R"json(children":{"Albertine":{"age":4},"Rupert":{")json"
+                       R"json(age":5}}})json";
+  CHECK(parse_json(input1, t1));
+  CHECK(4 == t1.get<children>()["Albertine"].get<age>());
+  CHECK(5 == t1.get<children>()["Rupert"].get<age>());
+}
+
+TEST_CASE("Structural4", "[Structural4]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::structural_parser;
+
+  using MyTuple =
+      named_tuple<std::string(name), std::vector<std::vector<int>>(matrix)>;
+
+  // One parser, and its index, reused over several documents
+  std::vector<MyTuple> data;
+  structural_parser parser;
+  std::string input1 =
+      R"json([{"name":"Robert","matrix":[[1],[2,3]]},{"name":"Marcelo"}])json";
+  std::string input2 = R"json([{"name":"Roger","matrix":[[4]]},{}])json";
+  CHECK(parser.parse(input1, data));
+  CHECK(parser.parse(input2, data));
+  REQUIRE(4u == data.size());
+  CHECK(3 == data[0].get<matrix>()[1][1]);
+  CHECK("Marcelo" == data[1].get<name>());
+  CHECK(4 == data[2].get<matrix>()[0][0]);
+}
+
+TEST_CASE("Structural5", "[Structural5]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::parse_json;
+
+  using MyTuple = named_tuple<std::string(name),
+                              std::map<std::string, int>(children),
+                              int(age)>;
+
+  MyTuple t1;
+  std::string input1 =
+      R"json({"name":"Marcelo","an_unknown_and_rather_long_key":3,)json"
+      R"json("children":{"a_key_longer_than_small_strings":1,"b":2},)json"
+      R"json("age":57})json";
+  CHECK(parse_json(input1, t1));
+  CHECK("Marcelo" == t1.get<name>());
+  CHECK(57 == t1.get<age>());
+  CHECK(1 == t1.get<children>()["a_key_longer_than_small_strings"]);
+  CHECK(2 == t1.get<children>()["b"]);
+}
+
+TEST_CASE("Structural6", "[Structural6]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::parse_json;
+
+  using MyTuple = named_tuple<std::string(name),
+                              string_ref(child1),
+                              std::vector<string_ref>(list),
+                              std::vector<std::string>(children)>;
+
+  // Escape sequences are decoded, views are only set on strings needing none
+  std::string input1 =
+      R"json({"name":"Mar\u0000celo é😀\"\\\/\t","child1":)json"
+      R"json("Coucou","list":["a","b\nc"],"children":["Rob\u0000ert"]})json";
+  MyTuple t1;
+  CHECK(parse_json(input1, t1));
+  CHECK(std::string("Mar\0celo \xc3\xa9\xf0\x9f\x98\x80\"\\/\t", 19u) ==
+        t1.get<name>());
+  CHECK("Coucou" == t1.get<child1>().str());
+  CHECK(static_cast<void const*>(input1.data() + input1.find("Coucou")) ==
+        static_cast<void const*>(t1.get<child1>().data));
+  REQUIRE(1u == t1.get<list>().size());
+  CHECK("a" == t1.get<list>()[0].str());
+  CHECK(std::string("Rob\0ert", 7u) == t1.get<children>()[0]);
+}
+
+// Parser specifics
+
+TEST_CASE("Structural7", "[Structural7]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::parse_json;
+
+  using MyTuple = named_tuple<std::string(name), std::vector<std::string>(list)>;
+
+  // Runs of backslashes and quotes around the 64 bytes blocks boundaries
+  for (size_t padding = 0; padding < 70u; ++padding) {
+    for (size_t backslashes = 0; backslashes < 5u; ++backslashes) {
+      std::string expected(backslashes, '\\');
+      expected += "\"x";
+      std::string escaped;
+      for (char c : expected)
+        escaped += '\\' == c || '"' == c ? std::string("\\") + c
+                                         : std::string(1u, c);
+      std::string input = std::string(padding, ' ') + R"json({"name":")json" +
+                          escaped + R"json(","list":[")json" + escaped +
+                          R"json(",""]})json";
+      MyTuple t1;
+      REQUIRE(parse_json(input, t1));
+      CHECK(expected == t1.get<name>());
+      REQUIRE(2u == t1.get<list>().size());
+      CHECK(expected == t1.get<list>()[0]);
+      CHECK(t1.get<list>()[1].empty());
+    }
+  }
+}
+
+TEST_CASE("Structural8", "[Structural8]") {
+  using namespace named_types;
+  using named_types::extensions::parsing::parse_json;
+
+  using MyTuple = named_tuple<int64_t(age),
+                              uint64_t(size),
+                              double(miles),
+                              bool(child1),
+                              std::vector<double>(list)>;
+
+  MyTuple t1;
+  CHECK(parse_json(R"json( { "age" : -9223372036854775808 , "size" :)json"
+                   R"json( 18446744073709551615, "miles": -1.5e-3,)json"
+                   "\n\t\"child1\":true, \"list\": [ 0, -0.0, 1E2,"
+                   " 123456789012345678901234567890 ] } ",
+                   t1));
+  CHECK(INT64_MIN == t1.get<age>());
+  CHECK(UINT64_MAX == t1.get<size>());
+  CHECK(-1.5e-3 == t1.get<miles>());
+  CHECK(t1.get<child1>());
+  REQUIRE(4u == t1.get<list>().size());
+  CHECK(100. == t1.get<list>()[2]);
+  CHECK(1.2345678901234568e29 == t1.get<list>()[3]);
+}
+
+TEST_CASE("Structural9", "[Structural9]") {
+  using namespace named_types;
+  using namespace named_types::extensions::parsing;
+
+  using MyTuple = named_tuple<std::string(name), std::vector<int>(list)>;
+  auto error = [](std::string const& input) {
+    MyTuple t1;
+    return parse_json(input, t1);
+  };
+
+  CHECK(structural_error::empty_document == error(" \n").error);
+  CHECK(structural_error::invalid_root == error("[]").error);
+  CHECK(structural_error::not_singular == error("{} {}").error);
+  CHECK(structural_error::unterminated_string == error(R"({"name":"ab)").error);
+  CHECK(structural_error::invalid_string_char ==
+        error("{\"name\":\"a\nb\"}").error);
+  CHECK(structural_error::invalid_escape == error(R"({"name":"\x"})").error);
+  CHECK(structural_error::invalid_escape ==
+        error(R"({"name":"\ud83d"})").error);
+  CHECK(structural_error::invalid_value == error(R"({"name":tru})").error);
+  CHECK(structural_error::invalid_value == error(R"({"name":})").error);
+  CHECK(structural_error::invalid_number == error(R"({"list":[1.]})").error);
+  CHECK(structural_error::invalid_number == error(R"({"list":[01]})").error);
+  CHECK(structural_error::number_too_big ==
+        error(R"({"list":[1e400]})").error);
+  CHECK(9u == error(R"({"list":[-1e400]})").offset);
+  CHECK(error(R"({"list":[1e-400]})"));
+  CHECK(structural_error::missing_name == error(R"({3:1})").error);
+  CHECK(structural_error::missing_colon == error(R"({"name" 1})").error);
+  CHECK(structural_error::missing_comma_or_end ==
+        error(R"({"list":[1 2]})").error);
+  CHECK(structural_error::missing_comma_or_end ==
+        error(R"({"name":"a")").error);
+  CHECK(structural_error::unexpected_value ==
+        error(R"({"list":[{}]})").error);
+  CHECK(structural_error::unexpected_value == error(R"({"name":[]})").error);
+
+  auto result = error(R"({"name":"a",  "list":[1, x]})");
+  CHECK(structural_error::invalid_value == result.error);
+  CHECK(25u == result.offset);
+
+  using Deep = std::vector<std::vector<std::vector<int>>>;
+  std::vector<Deep> deep;
+  CHECK(parse_json("[[[[1]]]]", deep));
+  CHECK(1 == deep[0][0][0][0]);
+  std::vector<int> flat;
+  CHECK(structural_error::unexpected_value == parse_json("[[1]]", flat).error);
+}
+
+TEST_CASE("Structural10", "[Structural10]") {
+  using namespace named_types;
+  using namespace named_types::extensions::parsing;
+
+  using MyTuple = named_tuple<
+      std::string(name),
+      int(age),
+      std::vector<named_tuple<std::string(name), size_t(age)>>(children),
+      std::map<std::string, std::vector<int>>(matrix),
+      std::vector<int>(miles)>;
+
+  // Skipped values hold keys of the schema, and objects of a wrong kind
+  std::string input = R"json({"name":"Marcelo","unknown":{"age":3,"x":[)json"
+                      R"json({"name":"Roger"},[[]]]},"age":57,"children":)json"
+                      R"json([{"name":"Albertine","age":{"age":8}},{"age")json"
+                      R"json(:4}],"extra":[[1],{"age":2}],"miles":[1,[2],)json"
+                      R"json(3],"matrix":{"a":[1],"b":{},"a":[2]}})json";
+  MyTuple t1;
+  auto result = parse_json(input, t1);
+  CHECK(structural_error::unexpected_value == result.error);
+  CHECK(input.find("{\"age\":3") == result.offset);
+
+  MyTuple t2;
+  CHECK(parse_json(input, t2, unknown_keys::skip));
+  CHECK("Marcelo" == t2.get<name>());
+  CHECK(57 == t2.get<age>());
+  REQUIRE(2u == t2.get<children>().size());
+  CHECK("Albertine" == t2.get<children>()[0].get<name>());
+  CHECK(0u == t2.get<children>()[0].get<age>());
+  CHECK(4u == t2.get<children>()[1].get<age>());
+  CHECK((std::vector<int>{1, 3}) == t2.get<miles>());
+  // Entries are created before their value is skipped
+  REQUIRE(2u == t2.get<matrix>().size());
+  CHECK((std::vector<int>{1}) == t2.get<matrix>()["a"]);
+  CHECK(t2.get<matrix>()["b"].empty());
+
+  // The root still has to match, and skipped values to be closed
+  std::vector<int> t3;
+  CHECK(structural_error::invalid_root ==
+        parse_json(input, t3, unknown_keys::skip).error);
+  MyTuple t4;
+  CHECK(structural_error::missing_comma_or_end ==
+        parse_json(R"json({"age":1,"unknown":[{"a":[]})json", t4,
+                   unknown_keys::skip)
+            .error);
+
+  // Skipped values must be well formed
+  auto skipped = [](std::string const& input) {
+    MyTuple tuple;
+    return parse_json(input, tuple, unknown_keys::skip).error;
+  };
+  CHECK(structural_error::missing_comma_or_end ==
+        skipped(R"json({"unknown":[1}})json"));
+  CHECK(structural_error::missing_comma_or_end ==
+        skipped(R"json({"unknown":{"a":1]})json"));
+  CHECK(structural_error::missing_colon ==
+        skipped(R"json({"unknown":{"a" 1}})json"));
+  CHECK(structural_error::missing_name ==
+        skipped(R"json({"unknown":{1:2}})json"));
+  CHECK(structural_error::invalid_value ==
+        skipped(R"json({"unknown":[tru]})json"));
+  CHECK(structural_error::invalid_value ==
+        skipped(R"json({"unknown":[1,]})json"));
+  CHECK(structural_error::invalid_value == skipped(R"json({"unknown":x})json"));
+  CHECK(structural_error::none ==
+        skipped(R"json({"unknown":{"a":[null,"b",-1.5e3,{}]}})json"));
+}
+
+TEST_CASE("Structural11", "[Structural11]") {
+  using namespace named_types;
+  using namespace named_types::extensions::parsing;
+
+  using Child = named_tuple<std::string(name), size_t(age)>;
+  using MyTuple = named_tuple<std::string(name),
+                              int(age),
+                              std::vector<Child>(children),
+                              std::list<std::string>(list),
+                              std::vector<int>(miles),
+                              std::map<std::string, int>(child1)>;
+
+  std::string input1 =
+      R"json({"name":"A name longer than small strings","age":57,)json"
+      R"json("children":[{"name":"A first child with a long name","age":3},)json"
+      R"json({"name":"A second child with a long name","age":4}],"list":)json"
+      R"json(["A first element of the list","A second element of the )json"
+      R"json(list"],"miles":[1,2,3],"child1":{"a":1}})json";
+  std::string input2 =
+      R"json({"name":"Another name, longer than small strings","age":58,)json"
+      R"json("children":[{"name":"A first child with a long game","age":5})json"
+      R"json(,{"name":"A second child with a long game","age":6}],"list":)json"
+      R"json(["A first element, of the list","A second element, of the )json"
+      R"json(list"],"miles":[4,5,6],"child1":{"b":2}})json";
+  std::string input3 = R"json({"age":1,"children":[{"name":"x"}],"list":)json"
+                       R"json(["y"],"miles":[7]})json";
+
+  structural_parser merging;
+  structural_parser reusing(unknown_keys::fail, parse_mode::reuse);
+  MyTuple t1;
+  REQUIRE(merging.parse(input1, t1));
+  REQUIRE(merging.parse(input2, t1));
+  CHECK(4u == t1.get<children>().size());
+  CHECK(4u == t1.get<list>().size());
+  CHECK(2u == t1.get<child1>().size());
+
+  REQUIRE(reusing.parse(input1, t1));
+  CHECK(2u == t1.get<children>().size());
+  CHECK(2u == t1.get<list>().size());
+  void const* name_data = t1.get<name>().data();
+  void const* children_data = t1.get<children>().data();
+  void const* child_name_data = t1.get<children>()[1].get<name>().data();
+  void const* miles_data = t1.get<miles>().data();
+  // List elements are rotated to the back when reused
+  std::vector<void const*> elements_data;
+  for (auto const& element : t1.get<list>())
+    elements_data.push_back(element.data());
+
+  REQUIRE(reusing.parse(input2, t1));
+  CHECK("Another name, longer than small strings" == t1.get<name>());
+  CHECK(58 == t1.get<age>());
+  REQUIRE(2u == t1.get<children>().size());
+  CHECK("A second child with a long game" ==
+        t1.get<children>()[1].get<name>());
+  CHECK(6u == t1.get<children>()[1].get<age>());
+  CHECK((std::list<std::string>{"A first element, of the list",
+                                "A second element, of the list"}) ==
+        t1.get<list>());
+  CHECK((std::vector<int>{4, 5, 6}) == t1.get<miles>());
+  REQUIRE(1u == t1.get<child1>().size());
+  CHECK(2 == t1.get<child1>()["b"]);
+  CHECK(name_data == static_cast<void const*>(t1.get<name>().data()));
+  CHECK(children_data == static_cast<void const*>(t1.get<children>().data()));
+  CHECK(child_name_data == static_cast<void const*>(
+                               t1.get<children>()[1].get<name>().data()));
+  CHECK(elements_data.front() ==
+        static_cast<void const*>(t1.get<list>().front().data()));
+  CHECK(elements_data.back() ==
+        static_cast<void const*>(t1.get<list>().back().data()));
+  CHECK(miles_data == static_cast<void const*>(t1.get<miles>().data()));
+
+  REQUIRE(reusing.parse(input3, t1));
+  CHECK(t1.get<name>().empty());
+  CHECK(1 == t1.get<age>());
+  REQUIRE(1u == t1.get<children>().size());
+  CHECK("x" == t1.get<children>()[0].get<name>());
+  CHECK(0u == t1.get<children>()[0].get<age>());
+  CHECK((std::list<std::string>{"y"}) == t1.get<list>());
+  CHECK((std::vector<int>{7}) == t1.get<miles>());
+  CHECK(t1.get<child1>().empty());
+}
+
+TEST_CASE("Structural12", "[Structural12]") {
+  using namespace named_types;
+  using namespace named_types::extensions::parsing;
+
+  using Record = named_tuple<std::string(name),
+                             int(age),
+                             double(size),
+                             std::vector<int>(miles),
+                             std::map<std::string, int>(children)>;
+  using Projection = projection_t<Record, miles, name>;
+
+  std::string input = R"json({"age":57,"name":"Marcelo","size":1.8,)json"
+                      R"json("children":{"a":1},"miles":[1,2],"list":)json"
+                      R"json([{"name":"Roger"}],"name2":"x"})json";
+  Projection projected;
+  CHECK(parse_json(input, projected, unknown_keys::skip));
+  CHECK("Marcelo" == projected.get<name>());
+  CHECK((std::vector<int>{1, 2}) == projected.get<miles>());
+
+  Record record;
+  record.get<age>() = 12;
+  record = std::move(projected);
+  CHECK("Marcelo" == record.get<name>());
+  CHECK(12 == record.get<age>());
+
+  // Only the first character of skipped scalars is checked, unlike when
+  // failing on them
+  Projection p2;
+  std::string input2 = R"json({"age":5x,"name":"Roger"})json";
+  CHECK(parse_json(input2, p2, unknown_keys::skip));
+  CHECK("Roger" == p2.get<name>());
+  CHECK(structural_error::invalid_number == parse_json(input2, p2).error);
+}
+
+TEST_CASE("Structural13", "[Structural13]") {
+  using namespace named_types;
+  using namespace named_types::extensions::parsing;
+
+  using Child = named_tuple<std::string(name), int(age)>;
+  using Record = named_tuple<std::array<double, 3>(size),
+                             small_vector<int, 4>(miles),
+                             small_vector<Child, 2>(children)>;
+
+  Record record;
+  REQUIRE(parse_json(R"json({"size":[1.5,2.5,3.5],"miles":[1,2,3],)json"
+                     R"json("children":[{"name":"Roger","age":4}]})json",
+                     record));
+  CHECK((std::array<double, 3>{{1.5, 2.5, 3.5}}) == record.get<size>());
+  CHECK((small_vector<int, 4>{1, 2, 3}) == record.get<miles>());
+  REQUIRE(1u == record.get<children>().size());
+  CHECK("Roger" == record.get<children>()[0].get<name>());
+
+  REQUIRE(parse_json(R"json({"size":[7],"miles":[4]})json", record));
+  CHECK((std::array<double, 3>{{7., 2.5, 3.5}}) == record.get<size>());
+  CHECK((small_vector<int, 4>{1, 2, 3, 4}) == record.get<miles>());
+
+  REQUIRE(parse_json(R"json({"size":[8],"miles":[5,6],"children":[]})json",
+                     record, unknown_keys::fail, parse_mode::reuse));
+  CHECK((std::array<double, 3>{{8., 0., 0.}}) == record.get<size>());
+  CHECK((small_vector<int, 4>{5, 6}) == record.get<miles>());
+  CHECK(record.get<children>().empty());
+
+  std::string input = R"json({"miles":[1,2,3,4,5]})json";
+  structural_result result =
+      parse_json(input, record, unknown_keys::skip, parse_mode::reuse);
+  CHECK(structural_error::too_many_elements == result.error);
+  CHECK(input.find('5') == result.offset);
+  CHECK(structural_error::too_many_elements ==
+        parse_json(R"json({"size":[1,2,3,[]]})json", record).error);
+
+  // Merging into full sequences fails at their first new element
+  Record full;
+  REQUIRE(parse_json(R"json({"miles":[1,2,3,4],"children":[{},{}]})json",
+                     full));
+  input = R"json({"children":[{"name":"x"}],"miles":[5]})json";
+  result = parse_json(input, full);
+  CHECK(structural_error::too_many_elements == result.error);
+  CHECK(input.find('{', 1u) == result.offset);
+  CHECK(structural_error::too_many_elements ==
+        parse_json(R"json({"miles":[5]})json", full, unknown_keys::skip)
+            .error);
+  CHECK((small_vector<int, 4>{1, 2, 3, 4}) == full.get<miles>());
+  CHECK(2u == full.get<children>().size());
+}
+
+TEST_CASE("Structural14", "[Structural14]") {
+  using namespace named_types;
+  using namespace named_types::extensions::parsing;
+
+  using Child = named_tuple<std::string(name), std::deque<int>(miles)>;
+  using Record = named_tuple<
+      std::map<std::string, int, std::greater<std::string>>(children),
+      std::deque<Child>(list)>;
+
+  Record record;
+  REQUIRE(parse_json(R"json({"children":{"a":1,"b":2},)json"
+                     R"json("list":[{"miles":[3]},{"name":"Z"}]})json",
+                     record));
+  REQUIRE(2u == record.get<children>().size());
+  CHECK("b" == record.get<children>().begin()->first);
+  REQUIRE(2u == record.get<list>().size());
+  CHECK((std::deque<int>{3}) == record.get<list>()[0].get<miles>());
+  CHECK("Z" == record.get<list>()[1].get<name>());
+
+  REQUIRE(parse_json(R"json({"list":[{"name":"W"}]})json", record,
+                     unknown_keys::fail, parse_mode::reuse));
+  CHECK(record.get<children>().empty());
+  REQUIRE(1u == record.get<list>().size());
+  CHECK("W" == record.get<list>()[0].get<name>());
+  CHECK(record.get<list>()[0].get<miles>().empty());
+}
+
+TEST_CASE("Structural15", "[Structural15]") {
+  using namespace named_types;
+  using namespace named_types::extensions::parsing;
+
+  using Child = named_tuple<std::string(name), std::vector<int>(miles)>;
+  using Record = named_tuple<std::vector<Child>(children),
+                             std::vector<std::vector<int>>(matrix),
+                             std::list<int>(list)>;
+
+  std::string input =
+      R"json({"children":[{"name":"a,b","miles":[1,2,3]},{"name":"[c]"},)json"
+      R"json({"miles":[]}],"matrix":[[1,2],[],[3]],"list":[1,2]})json";
+  Record grown;
+  REQUIRE(parse_json(input, grown));
+  Record reserved;
+  REQUIRE(parse_json(input, reserved, unknown_keys::fail, parse_mode::merge,
+                     array_sizing::prescan));
+  CHECK(grown == reserved);
+  REQUIRE(3u == reserved.get<children>().size());
+  CHECK(3u == reserved.get<children>().capacity());
+  CHECK(3u == reserved.get<children>()[0].get<miles>().capacity());
+  CHECK("[c]" == reserved.get<children>()[1].get<name>());
+  CHECK(3u == reserved.get<matrix>().capacity());
+  CHECK(2u == reserved.get<matrix>()[0].capacity());
+  CHECK(reserved.get<matrix>()[1].empty());
+  CHECK((std::list<int>{1, 2}) == reserved.get<list>());
+
+  // Merging reserves for the existing elements too
+  REQUIRE(parse_json(R"json({"matrix":[[4],[5]]})json", reserved,
+                     unknown_keys::fail, parse_mode::merge,
+                     array_sizing::prescan));
+  CHECK(5u == reserved.get<matrix>().size());
+  CHECK(5u <= reserved.get<matrix>().capacity());
+}
+
+TEST_CASE("Structural16", "[Structural16]") {
+  using namespace named_types;
+  using namespace named_types::extensions::parsing;
+
+  // Numbers are read with a '.' whatever the locale
+  comma_locale locale;
+  if (!locale.active) {
+    WARN("No locale with a ',' decimal point is installed");
+    return;
+  }
+  using Record = named_tuple<double(size), std::vector<double>(list)>;
+  Record record;
+  REQUIRE(parse_json(R"json({"size":1.5,"list":[-2.5e-3,0.75]})json", record));
+  CHECK(1.5 == record.get<size>());
+  CHECK((std::vector<double>{-2.5e-3, 0.75}) == record.get<list>());
+}
+
+TEST_CASE("Structural17", "[Structural17]") {
+  using namespace named_types;
+  using namespace named_types::extensions::parsing;
+
+  // Truncated documents fail at their end, also when a parser is reused
+  // after a longer document
+  using Record = named_tuple<int(age), std::vector<int>(miles)>;
+  structural_parser parser(unknown_keys::skip);
+  Record record;
+  REQUIRE(parser.parse(R"json({"age":1,"miles":[1,2,3],"x":[4]})json", record));
+  for (std::string input : {"{", R"json({"age":)json",
+                            R"json({"age":1)json", R"json({"miles":[1,)json",
+                            R"json({"x":)json", R"json({"x":[)json"}) {
+    auto result = parser.parse(input, record);
+    CHECK_FALSE(result);
+    CHECK(input.size() == result.offset);
+  }
+  std::vector<int> numbers;
+  CHECK(structural_error::invalid_value == parse_json("[", numbers).error);
+  std::vector<std::vector<int>> matrix;
+  CHECK(structural_error::invalid_value == parse_json("[[", matrix).error);
+  CHECK(structural_error::missing_comma_or_end ==
+        parse_json("[1", numbers).error);
+}
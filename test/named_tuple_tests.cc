@@ -1,4 +1,5 @@
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <tuple>
@@ -8,6 +9,7 @@
 #include <named_types/named_tuple.hpp>
 #include <named_types/literals/integral_string_literal.hpp>
 #include <named_types/rt_named_tuple.hpp>
+#include <named_types/perfect_hash.hpp>
 #include "catch.hpp"
 
 using namespace named_types;
@@ -303,6 +305,308 @@ SECTION("RuntimeView1") {
   CHECK("LeGros" == *reinterpret_cast<std::string const*>(raw_ptr));
 }
 
+SECTION("RuntimeRef1") {
+  attr<"name"_s> name_k;
+  attr<"size"_s> size_k;
+  attr<"surname"_s> surname_k;
+
+  using Tuple = decltype(make_named_tuple(name_k = std::string(),
+                                          surname_k = std::string(),
+                                          size_k = 0u));
+  std::vector<Tuple> tuples;
+  tuples.emplace_back(std::string("Roger"), std::string("LeGros"), 3u);
+  tuples.emplace_back(std::string("Marcel"), std::string("Dupont"), 4u);
+
+  // One descriptor per type, references hold two pointers
+  rt_descriptor const& descriptor = rt_descriptor_of(tuples[0]);
+  CHECK(&descriptor == &rt_descriptor_of(tuples[1]));
+  static_assert(sizeof(const_rt_ref) == 2u * sizeof(void*),
+                "References are an object and a descriptor");
+
+  Tuple const& first = tuples[0];
+  auto const_ref = make_rt_ref(first);
+  CHECK(3u == const_ref.size());
+  CHECK(1u == const_ref.index_of(typeid(attr<"surname"_s>)));
+  CHECK(2u == const_ref.index_of("size"));
+  CHECK(3u == const_ref.index_of("birthday"));
+  CHECK(typeid(unsigned) == const_ref.typeid_at("size"));
+  CHECK(typeid(void) == const_ref.typeid_at(3u));
+  REQUIRE(nullptr != const_ref.retrieve<std::string>("surname"));
+  CHECK("LeGros" == *const_ref.retrieve<std::string>("surname"));
+  CHECK(nullptr == const_ref.retrieve<int>("size"));
+  CHECK(nullptr == const_ref.retrieve_raw("birthday"));
+
+  for (Tuple& tuple : tuples) {
+    rt_ref ref(&tuple, descriptor);
+    *ref.retrieve<unsigned>(2u) += 10u;
+  }
+  CHECK(13u == std::get<2>(tuples[0]));
+  CHECK(14u == std::get<2>(tuples[1]));
+  rt_ref second = make_rt_ref(tuples[1]);
+  CHECK("Dupont" == *second.retrieve<std::string>("surname"));
+}
+
+SECTION("RuntimeRef2") {
+  attr<"name"_s> name_k;
+  attr<"size"_s> size_k;
+  attr<"surname"_s> surname_k;
+
+  auto t1 = make_named_tuple(name_k = std::string("Roger"),
+                             surname_k = std::string("LeGros"),
+                             size_k = 3u);
+  auto t2 = make_named_tuple(name_k = std::string("Marcel"),
+                             surname_k = std::string("Dupont"),
+                             size_k = 4u);
+
+  // Names given without building strings
+  char const buffer[] = "surname and size";
+  auto const_view = make_rt_view(t1);
+  CHECK(1u == const_view.index_of(rt_name(buffer, 7u)));
+  CHECK(3u == const_view.index_of(rt_name(buffer, 4u)));
+  CHECK(typeid(unsigned) == const_view.typeid_at(rt_name(buffer + 12, 4u)));
+  auto ref = make_rt_ref(t1);
+  CHECK(1u == ref.index_of(rt_name(buffer, 7u)));
+  CHECK(2u == ref.index_of(std::string("size")));
+#if __cplusplus >= 201703L
+  std::string_view const surname(buffer, 7u);
+  CHECK("LeGros" == *const_view.retrieve<std::string>(surname));
+  CHECK("LeGros" == *ref.retrieve<std::string>(surname));
+#endif
+
+  // Handles found once, used for every tuple of the type
+  rt_field<unsigned> size_field = ref.field<unsigned>("size");
+  rt_field<std::string> name_field = ref.field<std::string>(0u);
+  REQUIRE(size_field);
+  REQUIRE(name_field);
+  CHECK(!ref.field<int>("size"));
+  CHECK(!ref.field<int>("birthday"));
+  CHECK(3u == *size_field.in(ref));
+  *size_field.in(make_rt_ref(t2)) += 10u;
+  CHECK(14u == std::get<2>(t2));
+  CHECK("Marcel" == *name_field.in(make_rt_ref(t2)));
+
+  auto other = make_named_tuple(size_k = 3u);
+  CHECK(nullptr == size_field.in(make_rt_ref(other)));
+  CHECK(nullptr == rt_field<unsigned>().in(ref));
+}
+
+SECTION("RuntimeTypeId1") {
+  attr<"name"_s> name_k;
+  attr<"size"_s> size_k;
+
+  static_assert(rt_type_id_of<int>() == rt_type_id_of<int const>(),
+                "Type ids ignore cv-qualifiers");
+  static_assert(rt_type_id_of<int>() != rt_type_id_of<unsigned>(),
+                "Type ids tell types apart");
+  CHECK(rt_type_id_of<std::string>() != rt_type_id_of<std::string*>());
+
+  auto t1 = make_named_tuple(name_k = std::string("Roger"), size_k = 3u);
+  auto view = make_rt_view(t1);
+  CHECK(1u == view.index_of(rt_type_id_of<attr<"size"_s>>()));
+  CHECK(2u == view.index_of(rt_type_id_of<attr<"surname"_s>>()));
+  CHECK(rt_type_id_of<unsigned>() == view.type_id_at(1u));
+  CHECK(rt_type_id_of<void>() == view.type_id_at(2u));
+  REQUIRE(nullptr != view.retrieve<unsigned>(1u));
+  *view.retrieve<unsigned>(1u) = 4u;
+  CHECK(4u == std::get<1>(t1));
+  CHECK(nullptr == view.retrieve<int>(1u));
+
+  auto ref = make_rt_ref(t1);
+  CHECK(0u == ref.index_of(rt_type_id_of<attr<"name"_s>>()));
+  CHECK(rt_type_id_of<std::string>() == ref.type_id_at(0u));
+  CHECK(nullptr == ref.retrieve<std::string const*>(0u));
+
+  // Distinct types of a tuple have distinct ids
+  static_assert(__rt_ids_distinct<int, int const, unsigned, std::string>(),
+                "Type ids tell the types of a tuple apart");
+}
+
+SECTION("RuntimeVisit1") {
+  attr<"name"_s> name_k;
+  attr<"size"_s> size_k;
+
+  auto t1 = make_named_tuple(name_k = std::string("Roger"), size_k = 3u);
+  std::string printed;
+  auto print = [&printed](auto tag, auto const& value) {
+    std::ostringstream output;
+    output << type_name<typename decltype(tag)::value_type>::value << '='
+           << value;
+    printed = output.str();
+  };
+
+  CHECK(visit(t1, 1u, print));
+  CHECK("size=3" == printed);
+  CHECK(visit(t1, "name", print));
+  CHECK("name=Roger" == printed);
+  printed.clear();
+  CHECK(!visit(t1, 2u, print));
+  CHECK(!visit(t1, std::string("surname"), print));
+  CHECK(printed.empty());
+
+  // Fields are given with their own types, mutable through mutable views
+  auto increment = [](auto, auto& value) { value += value; };
+  CHECK(visit(make_rt_view(t1), "size", increment));
+  CHECK(6u == std::get<1>(t1));
+  CHECK(visit(t1, 0u, increment));
+  CHECK("RogerRoger" == std::get<0>(t1));
+
+  decltype(t1) const& t1_const = t1;
+  auto const_view = make_rt_view(t1_const);
+  CHECK(visit(const_view, "size", print));
+  CHECK("size=6" == printed);
+  bool is_const = false;
+  CHECK(visit(const_view, 0u, [&is_const](auto, auto& value) {
+    is_const = std::is_const<std::remove_reference_t<decltype(value)>>::value;
+  }));
+  CHECK(is_const);
+}
+
+SECTION("RuntimeAnyView1") {
+  attr<"name"_s> name_k;
+  attr<"size"_s> size_k;
+  attr<"surname"_s> surname_k;
+
+  auto person = make_named_tuple(name_k = std::string("Roger"),
+                                 surname_k = std::string("LeGros"));
+  auto box = make_named_tuple(size_k = 3u, name_k = std::string("Box"));
+
+  // Views of different types side by side, by value
+  std::vector<any_rt_view> views(3u);
+  views[0] = make_rt_ref(person);
+  views[1] = make_rt_ref(box);
+  CHECK(2u == views[0].size());
+  CHECK(2u == views[1].size());
+  CHECK("Roger" == *views[0].retrieve<std::string>("name"));
+  CHECK("Box" == *views[1].retrieve<std::string>("name"));
+  *views[1].retrieve<unsigned>("size") = 4u;
+  CHECK(4u == std::get<0>(box));
+
+  // Default constructed views have no field
+  CHECK(0u == views[2].size());
+  CHECK(0u == views[2].index_of("name"));
+  CHECK(nullptr == views[2].retrieve<std::string>("name"));
+  CHECK(nullptr == views[2].retrieve_raw(0u));
+  CHECK(!views[2].field<std::string>("name"));
+
+  any_const_rt_view const_view = views[0];
+  CHECK("LeGros" == *const_view.retrieve<std::string>("surname"));
+}
+
+SECTION("PerfectHash1") {
+  attr<"name"_s> name_k;
+  attr<"size"_s> size_k;
+  attr<"surname"_s> surname_k;
+
+  auto t1 = make_named_tuple(name_k = std::string("Roger"),
+                             surname_k = std::string("LeGros"),
+                             size_k = 3u);
+  using Index = named_tuple_key_index<decltype(t1)>;
+  static_assert(1u == Index::value.index_of("surname", 7u),
+                "Index of names must be computable at compile time.");
+  CHECK(0u == Index::get().index_of("name", 4u));
+  CHECK(1u == Index::get().index_of("surname", 7u));
+  CHECK(2u == Index::get().index_of("size", 4u));
+  CHECK(3u == Index::get().index_of("sizes", 5u));
+  CHECK(3u == Index::get().index_of("siz", 3u));
+  CHECK(3u == Index::get().index_of("", 0u));
+
+  // Runtime names
+  using RuntimeIndex =
+      named_tuple_key_index<named_tuple<std::string(attr<"name"_s>), int(age)>>;
+  CHECK(0u == RuntimeIndex::get().index_of("name", 4u));
+  CHECK(1u == RuntimeIndex::get().index_of("age4", 4u));
+  CHECK(2u == RuntimeIndex::get().index_of("age", 3u));
+
+  // Larger sets must stay collision free
+  std::vector<std::string> names;
+  for (size_t index = 0; index < 64u; ++index)
+    names.push_back("field_" + std::to_string(index));
+  char const* raw_names[64];
+  size_t lengths[64];
+  for (size_t index = 0; index < 64u; ++index) {
+    raw_names[index] = names[index].c_str();
+    lengths[index] = names[index].size();
+  }
+  perfect_hash<64> const index64(raw_names, lengths);
+  for (size_t index = 0; index < 64u; ++index)
+    CHECK(index == index64.index_of(names[index].c_str(), names[index].size()));
+  CHECK(64u == index64.index_of("field_64", 8u));
+
+  // Tables of 64 literal names are still built by the compiler, hashed
+  using Wide = named_tuple<
+                  int(attr<"fielda"_s>),
+                  int(attr<"fieldb"_s>),
+                  int(attr<"fieldc"_s>),
+                  int(attr<"fieldd"_s>),
+                  int(attr<"fielde"_s>),
+                  int(attr<"fieldf"_s>),
+                  int(attr<"fieldg"_s>),
+                  int(attr<"fieldh"_s>),
+                  int(attr<"fieldi"_s>),
+                  int(attr<"fieldj"_s>),
+                  int(attr<"fieldk"_s>),
+                  int(attr<"fieldl"_s>),
+                  int(attr<"fieldm"_s>),
+                  int(attr<"fieldn"_s>),
+                  int(attr<"fieldo"_s>),
+                  int(attr<"fieldp"_s>),
+                  int(attr<"fieldq"_s>),
+                  int(attr<"fieldr"_s>),
+                  int(attr<"fields"_s>),
+                  int(attr<"fieldt"_s>),
+                  int(attr<"fieldu"_s>),
+                  int(attr<"fieldv"_s>),
+                  int(attr<"fieldw"_s>),
+                  int(attr<"fieldx"_s>),
+                  int(attr<"fieldy"_s>),
+                  int(attr<"fieldz"_s>),
+                  int(attr<"fieldaa"_s>),
+                  int(attr<"fieldab"_s>),
+                  int(attr<"fieldac"_s>),
+                  int(attr<"fieldad"_s>),
+                  int(attr<"fieldae"_s>),
+                  int(attr<"fieldaf"_s>),
+                  int(attr<"fieldag"_s>),
+                  int(attr<"fieldah"_s>),
+                  int(attr<"fieldai"_s>),
+                  int(attr<"fieldaj"_s>),
+                  int(attr<"fieldak"_s>),
+                  int(attr<"fieldal"_s>),
+                  int(attr<"fieldam"_s>),
+                  int(attr<"fieldan"_s>),
+                  int(attr<"fieldao"_s>),
+                  int(attr<"fieldap"_s>),
+                  int(attr<"fieldaq"_s>),
+                  int(attr<"fieldar"_s>),
+                  int(attr<"fieldas"_s>),
+                  int(attr<"fieldat"_s>),
+                  int(attr<"fieldau"_s>),
+                  int(attr<"fieldav"_s>),
+                  int(attr<"fieldaw"_s>),
+                  int(attr<"fieldax"_s>),
+                  int(attr<"fielday"_s>),
+                  int(attr<"fieldaz"_s>),
+                  int(attr<"fieldba"_s>),
+                  int(attr<"fieldbb"_s>),
+                  int(attr<"fieldbc"_s>),
+                  int(attr<"fieldbd"_s>),
+                  int(attr<"fieldbe"_s>),
+                  int(attr<"fieldbf"_s>),
+                  int(attr<"fieldbg"_s>),
+                  int(attr<"fieldbh"_s>),
+                  int(attr<"fieldbi"_s>),
+                  int(attr<"fieldbj"_s>),
+                  int(attr<"fieldbk"_s>),
+                  int(attr<"fieldbl"_s>)>;
+  using WideIndex = named_tuple_key_index<Wide>;
+  static_assert(WideIndex::value.hashed() &&
+                    0u == WideIndex::value.index_of("fielda", 6u) &&
+                    37u == WideIndex::value.index_of("fieldal", 7u) &&
+                    63u == WideIndex::value.index_of("fieldbl", 7u) &&
+                    64u == WideIndex::value.index_of("fieldbm", 7u),
+                "Wide indexes must be computable at compile time.");
+}
+
 SECTION("ForEach1") {
   attr<"name"_s> name_k;
   attr<"size"_s> size_k;